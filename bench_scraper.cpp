@@ -0,0 +1,1017 @@
+// Benchmark suite for the C++ core against a local HTTP stand-in.
+//
+// Starts a stand-in server on 127.0.0.1 that speaks keep-alive HTTP/1.1 and
+// HTTP/2 with prior knowledge (h2c) on the same port, with configurable
+// latency, body size and error distributions, then runs each workload at
+// every in-flight level over both protocols:
+//   scrape    parallel_scrape over --requests fresh URLs   (latency per request)
+//   sherlock  Sherlock sweeps over a --sites catalog on the stand-in (per sweep)
+//   matrix    sherlock_matrix with --candidates usernames over that catalog (per batch)
+//   feed      the same batches through SweepFeed, drained as they run (time to first hit)
+//   harvest   parallel_harvester with its search base on the stand-in (per call)
+// and reports throughput, p50/p99 latency and the process RSS after the run.
+// One offline workload runs once, outside the protocol / level grid:
+//   extract   the harvester's old email + subdomain std::regexes against
+//             EmailScanner and the single-pass EntityExtractor over --pages
+//             synthetic result pages of --page-kb each (per page), then the
+//             "div.g a" HtmlSelector over the same pages in 16 KB chunks
+// No network access is needed, so numbers are comparable from run to run.
+//
+//   bench_scraper [--workloads scrape,sherlock,matrix,feed,harvest,extract] [--protocols h1,h2]
+//                 [--levels 1,8,64,256,1024] [--requests 2000] [--sites 300] [--candidates 8]
+//                 [--pages 48] [--page-kb 384]
+//                 [--latency-ms 50] [--latency-spread-ms 0] [--latency-dist fixed]
+//                 [--size 16384] [--size-spread 0] [--size-dist fixed]
+//                 [--error-rate 0] [--drop-rate 0]
+//
+// Distributions: fixed (always the mean), uniform (mean +/- spread) or
+// exp (mean plus an exponential tail averaging spread). --error-rate is the
+// fraction answered with a 500, --drop-rate the fraction never answered (the
+// HTTP/1.1 connection is closed, the HTTP/2 stream reset).
+#define NOMINMAX
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <queue>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <cmath>
+#include "scrape_engine.h"
+#include "connection_pool.h"
+#include "response_cache.h"
+#include "sherlock_catalog.h"
+#include "sherlock_check.h"
+#include "presence_cache.h"
+#include "email_scanner.h"
+#include "entity_extractor.h"
+#include "harvest_pipeline.h"
+#include "html_select.h"
+#include <regex>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <windows.h>
+#include <psapi.h>
+typedef SOCKET socket_t;
+#define close_socket closesocket
+#define SHUT_BOTH SD_BOTH
+#define SEND_FLAGS 0
+#else
+#include <sys/socket.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <csignal>
+typedef int socket_t;
+#define close_socket close
+#define INVALID_SOCKET (-1)
+#define SHUT_BOTH SHUT_RDWR
+// A client that hangs up mid-response (dropped connections are part of the
+// workload) must cost one failed send, not the process
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+#endif
+
+namespace fs = std::filesystem;
+
+std::map<std::string, ScrapeResultPtr> parallel_scrape(const std::vector<std::string>& urls,
+                                                       const CacheOptions& cache);
+void parallel_sherlock_async(const std::string& username,
+                             std::function<void(std::vector<std::string>&&)> done);
+HarvesterResults parallel_harvester(const std::string& domain, const std::string& search_url);
+
+static const char* kHarvestDomain = "example.com";
+
+// --- Distributions ---
+struct Distribution {
+    enum Kind { Fixed, Uniform, Exponential };
+    Kind kind = Fixed;
+    double mean = 0;
+    double spread = 0;
+
+    double sample(std::mt19937& rng) const {
+        switch (kind) {
+        case Uniform:
+            return std::max(0.0, std::uniform_real_distribution<double>(mean - spread, mean + spread)(rng));
+        case Exponential:
+            return spread > 0 ? mean + std::exponential_distribution<double>(1.0 / spread)(rng) : mean;
+        default:
+            return mean;
+        }
+    }
+
+    // Upper bound used to pre-build the body corpus
+    double ceiling() const {
+        switch (kind) {
+        case Uniform: return mean + spread;
+        case Exponential: return mean + spread * 12;
+        default: return mean;
+        }
+    }
+};
+
+static bool parse_kind(const std::string& text, Distribution::Kind& kind) {
+    if (text == "fixed") kind = Distribution::Fixed;
+    else if (text == "uniform") kind = Distribution::Uniform;
+    else if (text == "exp") kind = Distribution::Exponential;
+    else return false;
+    return true;
+}
+
+struct BenchOptions {
+    std::vector<std::string> workloads = {"scrape", "sherlock", "matrix", "feed", "harvest", "extract"};
+    std::vector<std::string> protocols = {"h1", "h2"};
+    std::vector<long> levels = {1, 8, 64, 256, 1024};
+    size_t requests = 2000;
+    size_t sites = 300;
+    size_t candidates = 8;
+    size_t pages = 48;
+    size_t page_kb = 384;
+    Distribution latency_ms{Distribution::Fixed, 50, 0};
+    Distribution body_size{Distribution::Fixed, 16384, 0};
+    double error_rate = 0;
+    double drop_rate = 0;
+};
+
+// What the stand-in does with one request.
+struct Reply {
+    enum Action { Answer, Fail, Drop };
+    Action action = Answer;
+    std::chrono::milliseconds delay{0};
+    size_t size = 0;
+};
+
+// --- The Stand-in Server ---
+// One thread per connection keeps the code short. HTTP/1.1 answers in order
+// with a sleep per request; HTTP/2 parks each stream in a timer queue so a
+// slow response never holds up its neighbours on the same connection.
+class StandInServer {
+public:
+    explicit StandInServer(const BenchOptions& options) : options_(options) {
+        // Pages look enough like search results for the harvester's regexes to find work
+        size_t longest = (size_t)std::max(0.0, options.body_size.ceiling()) + 1;
+        for (size_t n = 0; corpus_.size() < longest; n++) {
+            std::string id = std::to_string(n % 997);
+            corpus_ += "<div class=\"g\"><a href=\"https://host" + id + "." + kHarvestDomain + "/\">host" + id +
+                       "." + kHarvestDomain + "</a> contact staff" + id + "@" + kHarvestDomain + "</div>\n";
+        }
+        corpus_.resize(longest);
+
+        listener_ = socket(AF_INET, SOCK_STREAM, 0);
+        int yes = 1;
+        setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, (const char*)&yes, sizeof(yes));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0; // let the OS pick
+        bind(listener_, (sockaddr*)&addr, sizeof(addr));
+        listen(listener_, 4096);
+
+        socklen_t len = sizeof(addr);
+        getsockname(listener_, (sockaddr*)&addr, &len);
+        port_ = ntohs(addr.sin_port);
+
+        std::thread(&StandInServer::accept_loop, this).detach();
+    }
+
+    int port() const { return port_; }
+
+    Reply plan(bool head_only) {
+        static thread_local std::mt19937 rng(std::random_device{}());
+        Reply reply;
+        double roll = std::uniform_real_distribution<double>(0, 1)(rng);
+        if (roll < options_.drop_rate) reply.action = Reply::Drop;
+        else if (roll < options_.drop_rate + options_.error_rate) reply.action = Reply::Fail;
+
+        reply.delay = std::chrono::milliseconds((long long)options_.latency_ms.sample(rng));
+        if (!head_only && reply.action == Reply::Answer) {
+            reply.size = std::min(corpus_.size(), (size_t)options_.body_size.sample(rng));
+        }
+        return reply;
+    }
+
+    const std::string& corpus() const { return corpus_; }
+
+    static bool send_all(socket_t client, const char* data, size_t length) {
+        size_t sent = 0;
+        while (sent < length) {
+            int n = send(client, data + sent, (int)(length - sent), SEND_FLAGS);
+            if (n <= 0) return false;
+            sent += n;
+        }
+        return true;
+    }
+
+private:
+    void accept_loop() {
+        while (true) {
+            socket_t client = accept(listener_, nullptr, nullptr);
+            if (client == INVALID_SOCKET) continue;
+            int yes = 1;
+            setsockopt(client, IPPROTO_TCP, TCP_NODELAY, (const char*)&yes, sizeof(yes));
+            std::thread(&StandInServer::serve, this, client).detach();
+        }
+    }
+
+    void serve(socket_t client);
+    void serve_http1(socket_t client, std::string pending);
+
+    const BenchOptions& options_;
+    socket_t listener_;
+    int port_ = 0;
+    std::string corpus_;
+};
+
+void StandInServer::serve_http1(socket_t client, std::string pending) {
+    char buf[4096];
+    while (true) {
+        // Answer every complete request we have buffered
+        size_t end;
+        while ((end = pending.find("\r\n\r\n")) != std::string::npos) {
+            bool head_only = pending.compare(0, 5, "HEAD ") == 0;
+            pending.erase(0, end + 4);
+
+            Reply reply = plan(head_only);
+            std::this_thread::sleep_for(reply.delay);
+            if (reply.action == Reply::Drop) {
+                close_socket(client);
+                return;
+            }
+
+            std::string header = reply.action == Reply::Fail ? "HTTP/1.1 500 Internal Server Error\r\n"
+                                                             : "HTTP/1.1 200 OK\r\n";
+            header += "Content-Type: text/html\r\nContent-Length: " + std::to_string(reply.size) + "\r\n\r\n";
+            if (!send_all(client, header.data(), header.size()) ||
+                !send_all(client, corpus_.data(), reply.size)) {
+                close_socket(client);
+                return;
+            }
+        }
+
+        int n = recv(client, buf, sizeof(buf), 0);
+        if (n <= 0) break;
+        pending.append(buf, n);
+    }
+    close_socket(client);
+}
+
+// --- HTTP/2 (h2c, prior knowledge) ---
+// Just enough of RFC 9113 for curl: settings, pings, flow control and
+// responses. Request headers are never decoded beyond the method, and
+// responses only use HPACK static-table entries, so no HPACK state is kept.
+class H2Session {
+public:
+    H2Session(StandInServer& server, socket_t sock, std::string buffered)
+        : server_(server), sock_(sock), buffered_(std::move(buffered)) {}
+
+    void run() {
+        char preface[24];
+        if (!read_exact(preface, sizeof(preface)) || std::memcmp(preface, "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n", 24) != 0) {
+            close_socket(sock_);
+            return;
+        }
+
+        // Our SETTINGS: allow plenty of concurrent streams
+        char settings[6] = {0, 3, 0, 0, 0x10, 0}; // MAX_CONCURRENT_STREAMS = 4096
+        send_frame(kSettings, 0, 0, settings, sizeof(settings));
+
+        std::thread sender(&H2Session::send_loop, this);
+        read_loop();
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        changed_.notify_all();
+        shutdown(sock_, SHUT_BOTH);
+        sender.join();
+        close_socket(sock_);
+    }
+
+private:
+    enum : uint8_t { kData = 0, kHeaders = 1, kRstStream = 3, kSettings = 4, kPing = 6, kGoaway = 7,
+                     kWindowUpdate = 8, kContinuation = 9 };
+    enum : uint8_t { kEndStream = 0x1, kAck = 0x1, kEndHeaders = 0x4, kPadded = 0x8, kPriority = 0x20 };
+    static const size_t kMaxFrame = 16384; // peer's default SETTINGS_MAX_FRAME_SIZE
+
+    using Clock = std::chrono::steady_clock;
+    struct Pending {
+        Clock::time_point due;
+        uint32_t stream;
+        Reply reply;
+        bool operator>(const Pending& other) const { return due > other.due; }
+    };
+
+    static uint32_t read_u32(const unsigned char* p) {
+        return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+    }
+
+    bool read_exact(char* out, size_t length) {
+        size_t from_buffer = std::min(length, buffered_.size());
+        std::memcpy(out, buffered_.data(), from_buffer);
+        buffered_.erase(0, from_buffer);
+        for (size_t got = from_buffer; got < length;) {
+            int n = recv(sock_, out + got, (int)(length - got), 0);
+            if (n <= 0) return false;
+            got += n;
+        }
+        return true;
+    }
+
+    bool send_frame(uint8_t type, uint8_t flags, uint32_t stream, const char* payload, size_t length) {
+        unsigned char header[9] = {(unsigned char)(length >> 16), (unsigned char)(length >> 8), (unsigned char)length,
+                                   type, flags,
+                                   (unsigned char)(stream >> 24), (unsigned char)(stream >> 16),
+                                   (unsigned char)(stream >> 8), (unsigned char)stream};
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        return StandInServer::send_all(sock_, (const char*)header, sizeof(header)) &&
+               StandInServer::send_all(sock_, payload, length);
+    }
+
+    void read_loop() {
+        std::vector<char> payload;
+        uint32_t open_headers = 0;  // stream whose header block awaits CONTINUATION
+        bool open_head_only = false;
+
+        while (true) {
+            unsigned char header[9];
+            if (!read_exact((char*)header, sizeof(header))) return;
+            size_t length = ((size_t)header[0] << 16) | ((size_t)header[1] << 8) | header[2];
+            uint8_t type = header[3];
+            uint8_t flags = header[4];
+            uint32_t stream = read_u32(header + 5) & 0x7fffffff;
+            payload.resize(length);
+            if (length && !read_exact(payload.data(), length)) return;
+            const unsigned char* p = (const unsigned char*)payload.data();
+
+            switch (type) {
+            case kSettings:
+                if (flags & kAck) break;
+                for (size_t at = 0; at + 6 <= length; at += 6) {
+                    if (((p[at] << 8) | p[at + 1]) == 0x4) { // INITIAL_WINDOW_SIZE
+                        std::lock_guard<std::mutex> lock(mutex_);
+                        long long value = read_u32(p + at + 2);
+                        for (auto& pair : stream_windows_) pair.second += value - initial_window_;
+                        initial_window_ = value;
+                    }
+                }
+                changed_.notify_all();
+                send_frame(kSettings, kAck, 0, nullptr, 0);
+                break;
+
+            case kPing:
+                if (!(flags & kAck)) send_frame(kPing, kAck, 0, payload.data(), length);
+                break;
+
+            case kWindowUpdate:
+                if (length >= 4) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    long long increment = read_u32(p) & 0x7fffffff;
+                    if (stream == 0) connection_window_ += increment;
+                    else if (stream_windows_.count(stream)) stream_windows_[stream] += increment;
+                }
+                changed_.notify_all();
+                break;
+
+            case kHeaders: {
+                size_t at = 0;
+                if (flags & kPadded) at += 1;
+                if (flags & kPriority) at += 5;
+                // Skip dynamic table size updates; then 0x82 is the static-table ":method: GET".
+                // Anything else from our engine is a literal HEAD.
+                while (at < length && (p[at] & 0xe0) == 0x20) at++;
+                open_head_only = at < length && p[at] != 0x82;
+                if (flags & kEndHeaders) accept(stream, open_head_only);
+                else open_headers = stream;
+                break;
+            }
+
+            case kContinuation:
+                if ((flags & kEndHeaders) && stream == open_headers) {
+                    accept(stream, open_head_only);
+                    open_headers = 0;
+                }
+                break;
+
+            case kRstStream: {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stream_windows_.erase(stream);
+                changed_.notify_all();
+                break;
+            }
+
+            case kGoaway:
+                return;
+
+            default:
+                break; // DATA, PRIORITY, ... nothing to do for GET/HEAD traffic
+            }
+        }
+    }
+
+    void accept(uint32_t stream, bool head_only) {
+        Reply reply = server_.plan(head_only);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stream_windows_[stream] = initial_window_;
+            pending_.push({Clock::now() + reply.delay, stream, reply});
+        }
+        changed_.notify_all();
+    }
+
+    void send_loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!closed_) {
+            if (pending_.empty()) {
+                changed_.wait(lock);
+                continue;
+            }
+            if (pending_.top().due > Clock::now()) {
+                changed_.wait_until(lock, pending_.top().due);
+                continue;
+            }
+
+            Pending next = pending_.top();
+            pending_.pop();
+            if (!stream_windows_.count(next.stream)) continue; // reset by the client
+
+            lock.unlock();
+            bool alive = respond(next);
+            lock.lock();
+            stream_windows_.erase(next.stream);
+            if (!alive) return;
+        }
+    }
+
+    bool respond(const Pending& next) {
+        if (next.reply.action == Reply::Drop) {
+            char code[4] = {0, 0, 0, 2}; // INTERNAL_ERROR
+            return send_frame(kRstStream, 0, next.stream, code, sizeof(code));
+        }
+
+        // :status 200 / 500 are static-table entries 8 / 14; content-length is a
+        // literal without indexing on static name 28 (0x0f 0x0d).
+        std::string length = std::to_string(next.reply.size);
+        std::string block;
+        block += (char)(next.reply.action == Reply::Fail ? 0x8e : 0x88);
+        block += (char)0x0f;
+        block += (char)0x0d;
+        block += (char)length.size();
+        block += length;
+
+        size_t remaining = next.reply.size;
+        if (!send_frame(kHeaders, kEndHeaders | (remaining == 0 ? kEndStream : 0), next.stream, block.data(),
+                        block.size())) {
+            return false;
+        }
+
+        const char* data = server_.corpus().data();
+        while (remaining > 0) {
+            size_t chunk;
+            {
+                // Respect both flow-control windows
+                std::unique_lock<std::mutex> lock(mutex_);
+                changed_.wait(lock, [&] {
+                    auto it = stream_windows_.find(next.stream);
+                    return closed_ || it == stream_windows_.end() || (connection_window_ > 0 && it->second > 0);
+                });
+                auto it = stream_windows_.find(next.stream);
+                if (closed_) return false;
+                if (it == stream_windows_.end()) return true;
+                chunk = (size_t)std::min<long long>({(long long)remaining, (long long)kMaxFrame, connection_window_,
+                                                     it->second});
+                connection_window_ -= chunk;
+                it->second -= chunk;
+            }
+
+            remaining -= chunk;
+            if (!send_frame(kData, remaining == 0 ? kEndStream : 0, next.stream, data, chunk)) return false;
+            data += chunk;
+        }
+        return true;
+    }
+
+    StandInServer& server_;
+    socket_t sock_;
+    std::string buffered_;          // bytes read while sniffing the protocol
+    std::mutex write_mutex_;
+
+    std::mutex mutex_;              // guards everything below
+    std::condition_variable changed_;
+    bool closed_ = false;
+    std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> pending_;
+    std::map<uint32_t, long long> stream_windows_;  // open streams and their send windows
+    long long connection_window_ = 65535;
+    long long initial_window_ = 65535;
+};
+
+void StandInServer::serve(socket_t client) {
+    // An h2c client opens with "PRI * HTTP/2.0"; no HTTP/1.1 method starts with "PRI"
+    std::string pending;
+    char buf[4096];
+    while (pending.size() < 3) {
+        int n = recv(client, buf, sizeof(buf), 0);
+        if (n <= 0) {
+            close_socket(client);
+            return;
+        }
+        pending.append(buf, n);
+    }
+
+    if (pending.compare(0, 3, "PRI") == 0) {
+        H2Session(*this, client, std::move(pending)).run();
+    } else {
+        serve_http1(client, std::move(pending));
+    }
+}
+
+// --- Measurement helpers ---
+static double percentile(std::vector<double> samples, double p) {
+    if (samples.empty()) return 0;
+    std::sort(samples.begin(), samples.end());
+    size_t index = (size_t)std::ceil(p * samples.size());
+    return samples[std::min(samples.size() - 1, index == 0 ? 0 : index - 1)];
+}
+
+// Resident set size now and at its peak, in MB
+static void resident_memory(double& current, double& peak) {
+    current = peak = 0;
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        current = counters.WorkingSetSize / (1024.0 * 1024.0);
+        peak = counters.PeakWorkingSetSize / (1024.0 * 1024.0);
+    }
+#elif defined(__linux__)
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) current = std::atof(line.c_str() + 6) / 1024.0;
+        else if (line.compare(0, 6, "VmHWM:") == 0) peak = std::atof(line.c_str() + 6) / 1024.0;
+    }
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    peak = current = usage.ru_maxrss / (1024.0 * 1024.0); // bytes on macOS
+#endif
+}
+
+// Runs `count` blocking operations from `workers` threads, returning each one's latency in ms.
+static std::vector<double> closed_loop(size_t workers, size_t count, const std::function<bool(size_t)>& op,
+                                       size_t& failures) {
+    std::vector<double> latencies(count);
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> failed{0};
+
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < std::max<size_t>(1, std::min(workers, count)); w++) {
+        threads.emplace_back([&] {
+            for (size_t i; (i = next++) < count;) {
+                auto start = std::chrono::steady_clock::now();
+                if (!op(i)) failed++;
+                latencies[i] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    failures = failed;
+    return latencies;
+}
+
+struct RunResult {
+    size_t operations = 0;
+    size_t errors = 0;
+    size_t bytes = 0;
+    double seconds = 0;
+    std::vector<double> latencies_ms;
+};
+
+static RunResult run_scrape(const std::string& base, const BenchOptions& options, size_t round) {
+    // Fresh paths each round so no level benefits from the map collapsing duplicates
+    std::vector<std::string> urls;
+    urls.reserve(options.requests);
+    for (size_t i = 0; i < options.requests; i++) {
+        urls.push_back(base + "/page/" + std::to_string(round) + "/" + std::to_string(i));
+    }
+
+    RunResult run;
+    auto start = std::chrono::steady_clock::now();
+    std::map<std::string, ScrapeResultPtr> results = parallel_scrape(urls, CacheOptions());
+    run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    run.operations = results.size();
+    for (const auto& pair : results) {
+        run.latencies_ms.push_back(pair.second->timings.total * 1000.0);
+        if (!pair.second->ok() || pair.second->status != 200) run.errors++;
+        else run.bytes += pair.second->bytes;
+    }
+    return run;
+}
+
+static RunResult run_sherlock(const BenchOptions& options, long level, size_t round) {
+    // Enough sweeps to cover --requests checks, with enough of them at once to fill the window
+    size_t sweeps = std::max<size_t>(1, options.requests / std::max<size_t>(1, options.sites));
+    size_t workers = std::max<size_t>(1, (size_t)level / std::max<size_t>(1, options.sites));
+
+    std::atomic<size_t> missing{0};
+    RunResult run;
+    size_t failed_sweeps = 0;
+    auto start = std::chrono::steady_clock::now();
+    run.latencies_ms = closed_loop(workers, sweeps, [&](size_t i) {
+        std::mutex mutex;
+        std::condition_variable finished;
+        bool done = false;
+        size_t found = 0;
+        parallel_sherlock_async("bench" + std::to_string(round) + "_" + std::to_string(i),
+                                [&](std::vector<std::string>&& urls) {
+                                    std::lock_guard<std::mutex> lock(mutex);
+                                    found = urls.size();
+                                    done = true;
+                                    finished.notify_one();
+                                });
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [&] { return done; });
+        missing += options.sites - std::min(found, options.sites);
+        return found == options.sites;
+    }, failed_sweeps);
+    run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    run.operations = sweeps * options.sites; // throughput is in site checks
+    run.errors = missing;
+    return run;
+}
+
+static RunResult run_matrix(const BenchOptions& options, size_t round) {
+    // One batch already fills the window, so batches run back to back
+    size_t cells = std::max<size_t>(1, options.sites * options.candidates);
+    size_t batches = std::max<size_t>(1, options.requests / cells);
+
+    RunResult run;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < batches; b++) {
+        std::vector<std::string> usernames;
+        for (size_t c = 0; c < options.candidates; c++) {
+            usernames.push_back("bench" + std::to_string(round) + "_" + std::to_string(b) + "_" + std::to_string(c));
+        }
+
+        auto batch_start = std::chrono::steady_clock::now();
+        SherlockMatrix matrix = sherlock_matrix(usernames);
+        run.latencies_ms.push_back(
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - batch_start).count());
+
+        run.operations += matrix.cells.size();
+        run.errors += std::count_if(matrix.cells.begin(), matrix.cells.end(),
+                                    [](uint8_t cell) { return cell != (uint8_t)SiteStatus::Found; });
+    }
+    run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return run;
+}
+
+static RunResult run_feed(const BenchOptions& options, size_t round) {
+    size_t cells = std::max<size_t>(1, options.sites * options.candidates);
+    size_t batches = std::max<size_t>(1, options.requests / cells);
+
+    RunResult run;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < batches; b++) {
+        std::vector<std::string> usernames;
+        for (size_t c = 0; c < options.candidates; c++) {
+            usernames.push_back("feed" + std::to_string(round) + "_" + std::to_string(b) + "_" + std::to_string(c));
+        }
+
+        auto feed_start = std::chrono::steady_clock::now();
+        SweepFeed feed(usernames);
+        bool first = true;
+        size_t found = 0;
+        while (!feed.finished()) {
+            SweepBatch batch = feed.drain();
+            if (first && !batch.found.empty()) {
+                run.latencies_ms.push_back(
+                    std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - feed_start).count());
+                first = false;
+            }
+            found += batch.found.size();
+        }
+
+        run.operations += cells;
+        run.errors += cells - found;
+    }
+    run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return run;
+}
+
+static RunResult run_harvest(const std::string& base, const BenchOptions& options, long level, size_t round) {
+    // Each call is three searches
+    size_t calls = std::max<size_t>(1, options.requests / 3);
+    size_t workers = std::max<size_t>(1, (size_t)level / 3);
+
+    RunResult run;
+    auto start = std::chrono::steady_clock::now();
+    run.latencies_ms = closed_loop(workers, calls, [&](size_t i) {
+        std::string search = base + "/search/" + std::to_string(round) + "/" + std::to_string(i) + "?q=";
+        HarvesterResults found = parallel_harvester(kHarvestDomain, search);
+        return !found.emails.empty() || !found.subdomains.empty();
+    }, run.errors);
+    run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    run.operations = calls;
+    return run;
+}
+
+// A search-results page of about `size` bytes, shaped like the real thing:
+// mostly inline script, style and attribute-heavy markup, a target-domain
+// address every few KB, and the usual '@' decoys (CSS at-rules, handles,
+// addresses without a TLD, base64 images).
+static std::string results_page(size_t size, size_t seed) {
+    static const char* kFiller[] = {
+        "<script nonce=\"Xk2pQ9\">(function(){var a=window.google||{};a.kEI='x7Y0ZfG';a.sn='web';"
+        "function b(c,d){return c&&c.getAttribute?c.getAttribute(d):null}a.lt=b;})();</script>\n",
+        "<style>@media (max-width:640px){.g{margin:0 0 8px}.r a{font-size:18px}}@font-face{font-family:x;"
+        "src:url(f.woff2)}.yuRUbf{line-height:1.3}</style>\n",
+        "<div class=\"g tF2Cxc\" data-hveid=\"CAQQAA\"><div class=\"yuRUbf\"><a href=\"https://www.example.org/"
+        "team/about\" data-ved=\"2ahUKEwj\"><h3 class=\"LC20lb\">About our team</h3></a></div>"
+        "<div class=\"VwiC3b\">Follow @examplecorp for updates, or ping admin@localhost on the intranet.</div></div>\n",
+        "<img alt=\"\" src=\"data:image/png;base64,iVBORw0KGgoAAAANSUhEUgAAABAAAAAQCAYAAAAf8/9hAAAABHNCSVQICAgI"
+        "fAhkiAAAAAlwSFlzAAALEwAACxMBAJqcGAAAAZ5JREFUOI2Nk79LW1EUxz/n5iVGk2DQ2lK0g4ODg4uLi\">\n",
+    };
+    std::string page = "<!doctype html><html><head><title>results</title></head><body>\n";
+    std::mt19937 rng((unsigned)seed);
+    for (size_t n = 0; page.size() < size; n++) {
+        page += kFiller[rng() % 4];
+        if (n % 8 == 0) {
+            page += "<div class=\"g\"><span>Contact staff" + std::to_string(rng() % 997) + "@" + kHarvestDomain +
+                    " or sales." + std::to_string(n) + "@mail." + kHarvestDomain + "</span></div>\n";
+        }
+    }
+    page += "</body></html>\n";
+    return page;
+}
+
+// Same pages, every extractor; emails (and subdomains, where found) must agree.
+static void run_extract(const BenchOptions& options) {
+    std::vector<std::string> pages;
+    size_t bytes = 0;
+    for (size_t i = 0; i < options.pages; i++) {
+        pages.push_back(results_page(options.page_kb * 1024, i));
+        bytes += pages.back().size();
+    }
+
+    std::cout << "\nextract (" << pages.size() << " pages, " << std::fixed << std::setprecision(1)
+              << bytes / (1024.0 * 1024.0) << " MB; latency per page)" << std::endl;
+    std::cout << std::setw(10) << "method" << std::setw(10) << "seconds" << std::setw(11) << "pages/s"
+              << std::setw(9) << "MB/s" << std::setw(10) << "p50 ms" << std::setw(10) << "p99 ms"
+              << std::setw(10) << "matches" << std::endl;
+
+    static const char* kMethods[] = {"regex", "scanner", "single"};
+    std::regex email_regex(R"([a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,})");
+    std::regex subdomain_regex(std::string(R"(([a-zA-Z0-9.-]+\.)") + kHarvestDomain + ")");
+    std::vector<std::vector<std::string>> found[3];
+    std::vector<std::vector<std::string>> hosts[3];
+    for (int method = 0; method < 3; method++) {
+        std::vector<double> latencies;
+        size_t matches = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const std::string& page : pages) {
+            auto page_start = std::chrono::steady_clock::now();
+            std::vector<std::string> emails, subdomains;
+            if (method == 0) {
+                const char* end = page.data() + page.size();
+                for (std::cregex_iterator it(page.data(), end, email_regex), last; it != last; ++it) {
+                    emails.push_back(it->str());
+                }
+                for (std::cregex_iterator it(page.data(), end, subdomain_regex), last; it != last; ++it) {
+                    subdomains.push_back(it->str());
+                }
+            } else if (method == 1) {
+                emails = find_emails(page.data(), page.size());
+            } else {
+                ExtractedEntities entities = extract_entities(page.data(), page.size(),
+                                                              kEntityEmails | kEntitySubdomains, kHarvestDomain);
+                emails = std::move(entities.emails);
+                subdomains = std::move(entities.subdomains);
+            }
+            latencies.push_back(
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - page_start).count());
+            matches += emails.size() + subdomains.size();
+            found[method].push_back(std::move(emails));
+            hosts[method].push_back(std::move(subdomains));
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << std::setw(10) << kMethods[method] << std::setw(10) << std::setprecision(3)
+                  << seconds << std::setw(11) << std::setprecision(1) << pages.size() / seconds << std::setw(9)
+                  << bytes / seconds / (1024.0 * 1024.0) << std::setw(10) << percentile(latencies, 0.50)
+                  << std::setw(10) << percentile(latencies, 0.99) << std::setw(10) << matches << std::endl;
+    }
+    if (found[0] != found[1]) std::cout << "MISMATCH: the scanner and the regex disagree" << std::endl;
+    if (found[0] != found[2] || hosts[0] != hosts[2]) {
+        std::cout << "MISMATCH: the single-pass extractor and the regexes disagree" << std::endl;
+    }
+
+    // Link selection, fed the way the engine hands bodies over
+    std::vector<double> latencies;
+    size_t links = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const std::string& page : pages) {
+        auto page_start = std::chrono::steady_clock::now();
+        HtmlSelector html("div.g a", "href", true);
+        for (size_t i = 0; i < page.size(); i += 16384) html.feed(page.data() + i, std::min<size_t>(16384, page.size() - i));
+        html.finish();
+        links += html.values().size();
+        latencies.push_back(
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - page_start).count());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::setw(10) << "select" << std::setw(10) << std::setprecision(3) << seconds << std::setw(11)
+              << std::setprecision(1) << pages.size() / seconds << std::setw(9) << bytes / seconds / (1024.0 * 1024.0)
+              << std::setw(10) << percentile(latencies, 0.50) << std::setw(10) << percentile(latencies, 0.99)
+              << std::setw(10) << links << std::endl;
+}
+
+// Points ARGUS_CACHE_DIR at an emptied scratch directory, so the presence
+// table and latency history the bench fills are its own: nothing leaks into
+// the user's real cache, and nothing from an earlier run skews this one.
+// Must run before anything touches PresenceCache or SiteLatency.
+static void use_scratch_cache_dir() {
+    fs::path directory = fs::temp_directory_path() / "argus_bench_cache";
+    std::error_code ec;
+    fs::remove_all(directory, ec);
+    fs::create_directories(directory, ec);
+#ifdef _WIN32
+    _putenv_s("ARGUS_CACHE_DIR", directory.string().c_str());
+#else
+    setenv("ARGUS_CACHE_DIR", directory.string().c_str(), 1);
+#endif
+}
+
+// Writes a catalog whose sites all point at the stand-in and loads it. The
+// three errorTypes take turns; the stand-in never prints the errorMsg, so
+// message sites scan every body to the end.
+static void write_sherlock_catalog(const std::string& base, size_t sites) {
+    static const char* kRules[] = {
+        "\"errorType\": \"status_code\"",
+        "\"errorType\": \"message\", \"errorMsg\": \"Profile not found\"",
+        "\"errorType\": \"response_url\"",
+    };
+    fs::path path = fs::temp_directory_path() / "argus_bench_sherlock_sites.json";
+    std::ofstream file(path, std::ios::trunc);
+    file << "{\n";
+    for (size_t i = 0; i < sites; i++) {
+        file << "  \"Site" << i << "\": {\"url\": \"" << base << "/u/" << i
+             << "/{username}\", " << kRules[i % 3] << "}" << (i + 1 < sites ? ",\n" : "\n");
+    }
+    file << "}\n";
+    file.close();
+    SherlockCatalog::instance().reload(path.string());
+
+    // Every level must hit the stand-in, not verdicts from the level before
+    PresenceOptions uncached;
+    uncached.found_ttl_seconds = uncached.not_found_ttl_seconds = uncached.error_ttl_seconds = 0;
+    PresenceCache::instance().configure(uncached);
+}
+
+static std::vector<std::string> split(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+int main(int argc, char** argv) {
+#ifndef _WIN32
+    std::signal(SIGPIPE, SIG_IGN);  // platforms without MSG_NOSIGNAL
+#endif
+    BenchOptions options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        std::string value = argv[i + 1];
+        bool ok = true;
+        if (flag == "--workloads") options.workloads = split(value);
+        else if (flag == "--protocols") options.protocols = split(value);
+        else if (flag == "--levels") {
+            options.levels.clear();
+            for (const auto& level : split(value)) options.levels.push_back(std::atol(level.c_str()));
+        }
+        else if (flag == "--requests") options.requests = std::strtoul(value.c_str(), nullptr, 10);
+        else if (flag == "--sites") options.sites = std::strtoul(value.c_str(), nullptr, 10);
+        else if (flag == "--candidates") options.candidates = std::strtoul(value.c_str(), nullptr, 10);
+        else if (flag == "--pages") options.pages = std::strtoul(value.c_str(), nullptr, 10);
+        else if (flag == "--page-kb") options.page_kb = std::strtoul(value.c_str(), nullptr, 10);
+        else if (flag == "--latency-ms") options.latency_ms.mean = std::atof(value.c_str());
+        else if (flag == "--latency-spread-ms") options.latency_ms.spread = std::atof(value.c_str());
+        else if (flag == "--latency-dist") ok = parse_kind(value, options.latency_ms.kind);
+        else if (flag == "--size") options.body_size.mean = std::atof(value.c_str());
+        else if (flag == "--size-spread") options.body_size.spread = std::atof(value.c_str());
+        else if (flag == "--size-dist") ok = parse_kind(value, options.body_size.kind);
+        else if (flag == "--error-rate") options.error_rate = std::atof(value.c_str());
+        else if (flag == "--drop-rate") options.drop_rate = std::atof(value.c_str());
+        else ok = false;
+
+        if (!ok) {
+            std::cerr << "Bad flag: " << flag << " " << value << std::endl;
+            return 2;
+        }
+    }
+
+#ifdef _WIN32
+    WSADATA wsa;
+    WSAStartup(MAKEWORD(2, 2), &wsa);
+#endif
+
+    use_scratch_cache_dir();
+    StandInServer server(options);
+    std::string base = "http://127.0.0.1:" + std::to_string(server.port());
+    write_sherlock_catalog(base, options.sites);
+
+    std::cout << "Stand-in server on port " << server.port() << ": "
+              << options.latency_ms.mean << " ms latency (spread " << options.latency_ms.spread << "), "
+              << options.body_size.mean << " byte bodies (spread " << options.body_size.spread << "), "
+              << options.error_rate * 100 << "% errors, " << options.drop_rate * 100 << "% dropped" << std::endl;
+
+    ScrapeEngine& engine = ScrapeEngine::instance();
+    size_t round = 0;
+
+    for (const auto& workload : options.workloads) {
+        if (workload == "extract") {
+            run_extract(options);
+            continue;
+        }
+        bool site_checks = workload == "sherlock" || workload == "matrix" || workload == "feed";
+        const char* unit = workload == "scrape" ? "request" : workload == "sherlock" ? "sweep"
+                         : workload == "matrix" ? "batch" : workload == "feed" ? "first hit" : "call";
+        std::cout << "\n" << workload << " (ops/s in " << (site_checks ? "site checks" : std::string(unit) + "s")
+                  << ", latency per " << unit << ")" << std::endl;
+        std::cout << std::setw(6) << "proto" << std::setw(10) << "in-flight" << std::setw(10) << "seconds"
+                  << std::setw(11) << "ops/s" << std::setw(9) << "MB/s" << std::setw(10) << "p50 ms"
+                  << std::setw(10) << "p99 ms" << std::setw(8) << "errors" << std::setw(11) << "new conns"
+                  << std::setw(9) << "reused" << std::setw(9) << "RSS MB" << std::setw(9) << "peak MB" << std::endl;
+
+        for (const auto& protocol : options.protocols) {
+            for (long level : options.levels) {
+                EngineConfig config = engine.config();
+                config.max_in_flight = level;
+                config.http2 = protocol == "h2";
+                config.http2_prior_knowledge = protocol == "h2";
+                // The stand-in is a single host; don't let the per-host caps hide the window
+                config.max_host_connections = level;
+                config.default_host_limits.max_in_flight = level;
+                engine.configure(config);
+
+                ConnectionPool::instance().reset_stats();
+                RunResult run;
+                if (workload == "scrape") run = run_scrape(base, options, round);
+                else if (workload == "sherlock") run = run_sherlock(options, level, round);
+                else if (workload == "matrix") run = run_matrix(options, round);
+                else if (workload == "feed") run = run_feed(options, round);
+                else if (workload == "harvest") run = run_harvest(base, options, level, round);
+                else {
+                    std::cerr << "Unknown workload: " << workload << std::endl;
+                    return 2;
+                }
+                round++;
+
+                double rss, peak;
+                resident_memory(rss, peak);
+                std::map<std::string, unsigned long long> stats = ConnectionPool::instance().stats();
+                std::cout << std::setw(6) << protocol << std::setw(10) << level
+                          << std::setw(10) << std::fixed << std::setprecision(3) << run.seconds
+                          << std::setw(11) << std::setprecision(1) << (run.operations / run.seconds)
+                          << std::setw(9) << std::setprecision(2);
+                if (workload == "scrape") std::cout << (run.bytes / run.seconds / (1024.0 * 1024.0));
+                else std::cout << "-"; // bodies stay inside the checker / harvester
+                std::cout
+                          << std::setw(10) << std::setprecision(1) << percentile(run.latencies_ms, 0.50)
+                          << std::setw(10) << percentile(run.latencies_ms, 0.99)
+                          << std::setw(8) << run.errors
+                          << std::setw(11) << stats["connections_opened"]
+                          << std::setw(9) << stats["connections_reused"]
+                          << std::setw(9) << rss << std::setw(9) << peak << std::endl;
+            }
+        }
+    }
+    return 0;
+}
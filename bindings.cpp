@@ -4,32 +4,658 @@
 #include <vector>
 #include <map>
 #include <regex>
+#include <memory>
+#include <functional>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include "connection_pool.h"
+#include "scrape_engine.h"
+#include "body_buffer.h"
+#include "response_cache.h"
+#include "sherlock_catalog.h"
+#include "sherlock_check.h"
+#include "site_latency.h"
+#include "presence_cache.h"
+#include "username_variants.h"
+#include "entity_extractor.h"
+#include "harvest_pipeline.h"
+#include "html_select.h"
+#include "select_stream.h"
 
 namespace py = pybind11;
 
 // Forward declarations
-void scrape_url(struct ScrapeJob& job);
-std::map<std::string, std::string> parallel_scrape(const std::vector<std::string>& urls);
+ScrapeResult scrape_url(const std::string& url);
+std::map<std::string, ScrapeResultPtr> parallel_scrape(const std::vector<std::string>& urls,
+                                                       const CacheOptions& cache);
 std::vector<std::string> parallel_sherlock(const std::string& username);
-struct HarvesterResults {
-    std::vector<std::string> emails;
-    std::vector<std::string> subdomains;
+void parallel_sherlock_async(const std::string& username,
+                             std::function<void(std::vector<std::string>&&)> done);
+HarvesterResults parallel_harvester(const std::string& domain, const std::string& search_url);
+
+// --- asyncio bridge ---
+// The engine's loop thread must never wait for the GIL: a Python thread
+// holding it while it blocks on the engine (a stream's next(), a cache
+// call) would deadlock the two. Completions are queued here instead and
+// run by one daemon threading.Thread, which takes the GIL for them. Every
+// py::object an awaitable holds is also released there.
+class AsyncDispatcher {
+public:
+    static AsyncDispatcher& instance() {
+        static AsyncDispatcher* dispatcher = new AsyncDispatcher();
+        return *dispatcher;
+    }
+
+    // Any thread, GIL or not. The job runs (and is destroyed) with the GIL held.
+    void post(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_.push_back(std::move(job));
+        }
+        ready_cv_.notify_one();
+    }
+
+    // Python thread with the GIL held; starts the thread on first use.
+    void start() {
+        if (started_) return;
+        started_ = true;
+        py::module_ threading = py::module_::import("threading");
+        py::cpp_function run([this] { this->run(); });
+        threading.attr("Thread")(py::arg("target") = run, py::arg("name") = "argus-async-completions",
+                                 py::arg("daemon") = true)
+            .attr("start")();
+    }
+
+private:
+    void run() {
+        for (;;) {
+            std::deque<std::function<void()>> batch;
+            {
+                py::gil_scoped_release release;
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_cv_.wait(lock, [this] { return !jobs_.empty(); });
+                batch.swap(jobs_);
+            }
+            for (auto& job : batch) {
+                try {
+                    job();
+                } catch (const std::exception& e) {
+                    PyErr_SetString(PyExc_RuntimeError, e.what());
+                    PyErr_WriteUnraisable(nullptr);
+                }
+                job = nullptr;
+            }
+        }
+    }
+
+    std::mutex mutex_;
+    std::condition_variable ready_cv_;
+    std::deque<std::function<void()>> jobs_;
+    bool started_ = false;                  // guarded by the GIL
+};
+
+// One awaitable: the caller's running loop and the future we hand back.
+// The dispatcher resolves it through call_soon_threadsafe, so no Python
+// thread is parked per call.
+static py::object* g_resolve_future = nullptr;
+
+struct AsyncTarget : std::enable_shared_from_this<AsyncTarget> {
+    py::object loop;
+    py::object future;
+
+    // Usually runs on the engine thread, which has no GIL: the references
+    // move into a job and are dropped on the dispatcher.
+    ~AsyncTarget() {
+        if (!loop && !future) return;
+        AsyncDispatcher::instance().post([loop = std::move(loop), future = std::move(future)] {});
+    }
+
+    // Any thread. make_value runs later on the dispatcher, with the GIL
+    // held, so it must own (not reference) what it converts.
+    template <typename MakeValue>
+    void resolve(MakeValue make_value) {
+        AsyncDispatcher::instance().post([self = shared_from_this(), make_value = std::move(make_value)] {
+            try {
+                self->loop.attr("call_soon_threadsafe")(*g_resolve_future, self->future, make_value());
+            } catch (py::error_already_set& e) {
+                // Usually the loop was closed before the transfer finished
+                e.discard_as_unraisable("argus_cpp_core async completion");
+            }
+        });
+    }
 };
-HarvesterResults parallel_harvester(const std::string& domain);
+
+static std::shared_ptr<AsyncTarget> new_async_target() {
+    AsyncDispatcher::instance().start();
+    auto target = std::make_shared<AsyncTarget>();
+    target->loop = py::module_::import("asyncio").attr("get_running_loop")();
+    target->future = target->loop.attr("create_future")();
+    return target;
+}
 
 // This creates the Python module
 PYBIND11_MODULE(argus_cpp_core, m) {
     m.doc() = "ARGUS C++ Core: High-performance modules"; 
-    
+
+    // --- Scrape results ---
+    py::class_<ScrapeTimings>(m, "ScrapeTimings")
+        .def_readonly("dns", &ScrapeTimings::dns)
+        .def_readonly("connect", &ScrapeTimings::connect)
+        .def_readonly("tls", &ScrapeTimings::tls)
+        .def_readonly("ttfb", &ScrapeTimings::ttfb)
+        .def_readonly("total", &ScrapeTimings::total)
+        .def("__repr__", [](const ScrapeTimings& t) {
+            return "<ScrapeTimings dns=" + std::to_string(t.dns) + " connect=" + std::to_string(t.connect) +
+                   " tls=" + std::to_string(t.tls) + " ttfb=" + std::to_string(t.ttfb) +
+                   " total=" + std::to_string(t.total) + ">";
+        });
+
+    // The body is exposed through the buffer protocol: result.body (or
+    // memoryview(result)) points straight at the C++ string and keeps the
+    // result alive. Nothing is decoded until text() is called.
+    py::class_<ScrapeResult, ScrapeResultPtr>(m, "ScrapeResult", py::buffer_protocol())
+        .def_readonly("url", &ScrapeResult::url)
+        .def_readonly("final_url", &ScrapeResult::final_url)
+        .def_readonly("status", &ScrapeResult::status)
+        .def_readonly("error", &ScrapeResult::error)
+        .def_readonly("headers", &ScrapeResult::headers)
+        .def_readonly("bytes", &ScrapeResult::bytes)
+        .def_readonly("timings", &ScrapeResult::timings)
+        .def_readonly("cache_status", &ScrapeResult::cache_status)
+        .def_property_readonly("ok", &ScrapeResult::ok)
+        .def_property_readonly("body", [](py::object self) { return py::memoryview(self); })
+        .def_buffer([](ScrapeResult& r) {
+            return py::buffer_info((void*)r.body.data(), 1, py::format_descriptor<unsigned char>::format(),
+                                   1, {(py::ssize_t)r.body.size()}, {1}, /*readonly=*/true);
+        })
+        .def("text", [](const ScrapeResult& r, const std::string& encoding, const std::string& errors) {
+                 // The only place a body is ever decoded; the raw bytes stay in C++
+                 PyObject* text = PyUnicode_Decode(r.body.data(), (Py_ssize_t)r.body.size(),
+                                                   encoding.c_str(), errors.c_str());
+                 if (!text) throw py::error_already_set();
+                 return py::reinterpret_steal<py::str>(text);
+             },
+             "Decodes the body", py::arg("encoding") = "utf-8", py::arg("errors") = "replace")
+        .def("__len__", [](const ScrapeResult& r) { return r.body.size(); })
+        .def("__repr__", [](const ScrapeResult& r) {
+            std::string state = r.ok() ? std::to_string(r.status) : "error: " + r.error;
+            return "<ScrapeResult " + state + " " + r.url + " (" + std::to_string(r.bytes) + " bytes)>";
+        });
+
+    // --- Response cache ---
+    // Pass a CacheOptions to any scrape call to answer repeats from disk:
+    //   parallel_scrape(urls, cache=CacheOptions(ttl_seconds=3600))
+    // directory="" keeps entries in scrape_cache under the user's cache directory.
+    py::class_<CacheOptions>(m, "CacheOptions")
+        .def(py::init([](double ttl_seconds, unsigned long long max_bytes, const std::string& directory) {
+                 CacheOptions options;
+                 options.ttl_seconds = ttl_seconds;
+                 options.max_bytes = max_bytes;
+                 options.directory = directory;
+                 return options;
+             }),
+             py::arg("ttl_seconds") = 0.0, py::arg("max_bytes") = 256ull << 20,
+             py::arg("directory") = "")
+        .def_readwrite("ttl_seconds", &CacheOptions::ttl_seconds)
+        .def_readwrite("max_bytes", &CacheOptions::max_bytes)
+        .def_readwrite("directory", &CacheOptions::directory);
+
+    m.def("cache_stats", [] { return ResponseCache::instance().stats(); },
+          "Response cache counters (hits, misses, revalidated, stores, evictions)");
+
+    m.def("scrape_url", &scrape_url,
+          "Scrapes one URL on the shared engine and waits for the result",
+          py::arg("url"), py::call_guard<py::gil_scoped_release>());
+
     // --- NEW: Expose the parallel_scrape function ---
-    // It will take a Python list[str] and return a Python dict[str, str]
+    // It will take a Python list[str] and return a Python dict[str, ScrapeResult]
     m.def("parallel_scrape", &parallel_scrape, 
-          "Scrapes a list of URLs in parallel using TBB and libcurl",
-          py::arg("urls"));
+          "Scrapes a list of URLs concurrently on the shared curl_multi engine",
+          py::arg("urls"), py::arg("cache") = CacheOptions(), py::call_guard<py::gil_scoped_release>());
+
+    // --- Streaming scrape ---
+    // for url, result in scrape_stream(urls): ... yields results as they finish.
+    // The GIL is released while waiting, so other Python threads keep running.
+    py::class_<ScrapeStream>(m, "ScrapeStream")
+        .def("__iter__", [](ScrapeStream& self) -> ScrapeStream& { return self; })
+        .def("__next__", [](ScrapeStream& self) {
+            ScrapeResult response;
+            bool more;
+            {
+                py::gil_scoped_release release;
+                more = self.next(response);
+            }
+            if (!more) throw py::stop_iteration();
+            ScrapeResultPtr result = std::make_shared<ScrapeResult>(std::move(response));
+            return py::make_tuple(result->url, result);
+        })
+        .def("__len__", &ScrapeStream::remaining);
+
+    m.def("scrape_stream", [](const std::vector<std::string>& urls, const CacheOptions& cache) {
+              return std::make_unique<ScrapeStream>(urls, cache);
+          },
+          "Starts scraping a list of URLs and returns an iterator of (url, ScrapeResult) pairs in completion order",
+          py::arg("urls"), py::arg("cache") = CacheOptions(), py::call_guard<py::gil_scoped_release>());
+
+    // --- Selecting fetch ---
+    // for url, page in select_stream(urls, "div.g a", "href", first=True): page.values
+    // The selector runs on the body as it downloads; the body itself never reaches Python.
+    py::class_<SelectResult>(m, "SelectResult")
+        .def_readonly("url", &SelectResult::url)
+        .def_readonly("status", &SelectResult::status)
+        .def_readonly("error", &SelectResult::error)
+        .def_readonly("bytes", &SelectResult::bytes)
+        .def_readonly("values", &SelectResult::values)
+        .def_property_readonly("ok", &SelectResult::ok)
+        .def("__repr__", [](const SelectResult& r) {
+            return "<SelectResult " + r.url + " status=" + std::to_string(r.status) +
+                   " values=" + std::to_string(r.values.size()) + ">";
+        });
+
+    py::class_<SelectStream>(m, "SelectStream")
+        .def("__iter__", [](SelectStream& self) -> SelectStream& { return self; })
+        .def("__next__", [](SelectStream& self) {
+            SelectResult result;
+            bool more;
+            {
+                py::gil_scoped_release release;
+                more = self.next(result);
+            }
+            if (!more) throw py::stop_iteration();
+            std::string url = result.url;
+            return py::make_tuple(url, std::move(result));
+        })
+        .def("__len__", &SelectStream::remaining);
+
+    m.def("select_stream",
+          [](const std::vector<std::string>& urls, const std::string& selector, const std::string& attribute,
+             bool first, size_t max_values) {
+              return std::make_unique<SelectStream>(urls, selector, attribute, first, max_values);
+          },
+          "Fetches the URLs and, as each body streams in, collects `attribute` from the elements matching "
+          "`selector` (tag, .class, descendant). first=True keeps one match per element matching the first "
+          "compound; max_values > 0 stops a page's download once that many are found. Returns an iterator "
+          "of (url, SelectResult) pairs in completion order.",
+          py::arg("urls"), py::arg("selector"), py::arg("attribute"), py::arg("first") = false,
+          py::arg("max_values") = 0, py::call_guard<py::gil_scoped_release>());
+
+    m.def("html_select",
+          [](const std::string& html, const std::string& selector, const std::string& attribute, bool first,
+             size_t max_values) {
+              HtmlSelector parsed(selector, attribute, first, max_values);
+              py::gil_scoped_release release;
+              parsed.feed(html.data(), html.size());
+              parsed.finish();
+              return std::move(parsed.values());
+          },
+          "Same selection as select_stream, over HTML already in hand",
+          py::arg("html"), py::arg("selector"), py::arg("attribute"), py::arg("first") = false,
+          py::arg("max_values") = 0);
+
+    // --- Sherlock site catalog ---
+    // Parsed here, once, so the first sweep doesn't pay for it. A missing
+    // catalog isn't fatal at import: the first sweep (or reload) retries.
+    try {
+        SherlockCatalog::instance().reload();
+    } catch (const std::exception&) {
+    }
+
+    m.def("reload_sherlock_sites", [](const std::string& path) { return SherlockCatalog::instance().reload(path); },
+          "Re-reads the Sherlock site catalog (or its compiled .bin when up to date); returns the number of sites loaded",
+          py::arg("path") = SherlockCatalog::kDefaultPath, py::call_guard<py::gil_scoped_release>());
+
+    m.def("sherlock_site_count", [] { return SherlockCatalog::instance().get()->sites.size(); },
+          "Number of sites in the loaded Sherlock catalog");
 
     m.def("parallel_sherlock", &parallel_sherlock,
           "Checks for a username across top social sites in parallel",
+          py::arg("username"), py::call_guard<py::gil_scoped_release>());
+
+    // --- Structured username sweep ---
+    py::enum_<SiteStatus>(m, "SiteStatus")
+        .value("FOUND", SiteStatus::Found)
+        .value("NOT_FOUND", SiteStatus::NotFound)
+        .value("UNKNOWN", SiteStatus::Unknown);
+
+    py::class_<SiteCheck>(m, "SiteCheck")
+        .def_readonly("site", &SiteCheck::site)
+        .def_readonly("url", &SiteCheck::url)
+        .def_readonly("status", &SiteCheck::status)
+        .def_readonly("http_status", &SiteCheck::http_status)
+        .def_readonly("elapsed", &SiteCheck::elapsed)
+        .def_readonly("error", &SiteCheck::error)
+        .def_readonly("cached", &SiteCheck::cached)
+        .def_property_readonly("found", [](const SiteCheck& c) { return c.status == SiteStatus::Found; })
+        .def("__repr__", [](const SiteCheck& c) {
+            static const char* names[] = {"found", "not found", "unknown"};
+            return "<SiteCheck " + c.site + " " + names[(int)c.status] + " " + c.url + ">";
+        });
+
+    m.def("sherlock_sweep", &sherlock_sweep,
+          "Checks a username against every catalog site; returns a SiteCheck per site",
+          py::arg("username"), py::call_guard<py::gil_scoped_release>());
+
+    // for check in sherlock_stream(username): ... yields SiteChecks as sites answer
+    py::class_<SherlockStream>(m, "SherlockStream")
+        .def("__iter__", [](SherlockStream& self) -> SherlockStream& { return self; })
+        .def("__next__", [](SherlockStream& self) {
+            SiteCheck check;
+            bool more;
+            {
+                py::gil_scoped_release release;
+                more = self.next(check);
+            }
+            if (!more) throw py::stop_iteration();
+            return check;
+        })
+        .def("__len__", &SherlockStream::remaining);
+
+    m.def("sherlock_stream", [](const std::string& username) { return std::make_unique<SherlockStream>(username); },
+          "Starts a username sweep and returns an iterator of SiteCheck in completion order",
+          py::arg("username"), py::call_guard<py::gil_scoped_release>());
+
+    // Live sweep events for a UI:
+    //   for batch in sherlock_feed([username]): send(batch.found, batch.done, batch.total)
+    // Each batch is everything that landed since the last one.
+    py::class_<SweepHit>(m, "SweepHit")
+        .def_readonly("username", &SweepHit::username)
+        .def_readonly("site", &SweepHit::site)
+        .def_readonly("url", &SweepHit::url);
+
+    py::class_<SweepBatch>(m, "SweepBatch")
+        .def_readonly("events", &SweepBatch::events)
+        .def_readonly("done", &SweepBatch::done)
+        .def_readonly("total", &SweepBatch::total)
+        .def_readonly("finished", &SweepBatch::finished)
+        .def_readonly("found", &SweepBatch::found)
+        .def_readonly("unknown", &SweepBatch::unknown);
+
+    py::class_<SweepFeed>(m, "SweepFeed")
+        .def("drain", &SweepFeed::drain,
+             "Waits up to timeout_ms for events, then returns everything queued as one SweepBatch",
+             py::arg("max_events") = 4096, py::arg("timeout_ms") = 250, py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("finished", &SweepFeed::finished)
+        .def("__iter__", [](SweepFeed& self) -> SweepFeed& { return self; })
+        .def("__next__", [](SweepFeed& self) {
+            // Skips empty (timed-out) batches; the last batch always comes through
+            if (self.finished()) throw py::stop_iteration();
+            SweepBatch batch;
+            {
+                py::gil_scoped_release release;
+                do {
+                    batch = self.drain();
+                } while (batch.events == 0 && !batch.finished);
+            }
+            return batch;
+        });
+
+    m.def("sherlock_feed", [](const std::vector<std::string>& usernames) { return std::make_unique<SweepFeed>(usernames); },
+          "Starts a sweep of the usernames and returns a SweepFeed of batched progress / hit events",
+          py::arg("usernames"), py::call_guard<py::gil_scoped_release>());
+
+    // The matrix is a (usernames x sites) uint8 buffer of SiteStatus values:
+    // numpy.asarray(matrix) or memoryview(matrix) reads it without a copy.
+    py::class_<SherlockMatrix>(m, "SherlockMatrix", py::buffer_protocol())
+        .def_readonly("usernames", &SherlockMatrix::usernames)
+        .def_property_readonly("sites", [](const SherlockMatrix& matrix) {
+            std::vector<std::string> names;
+            for (size_t i = 0; i < matrix.site_count(); i++) names.emplace_back(matrix.catalog->sites[i].name);
+            return names;
+        })
+        .def("status", [](const SherlockMatrix& matrix, size_t user, size_t site) {
+                 if (user >= matrix.usernames.size() || site >= matrix.site_count()) throw py::index_error();
+                 return matrix.at(user, site);
+             },
+             py::arg("user"), py::arg("site"))
+        .def("profiles", [](const SherlockMatrix& matrix) {
+                 // username -> profile URLs found
+                 std::map<std::string, std::vector<std::string>> out;
+                 for (size_t user = 0; user < matrix.usernames.size(); user++) {
+                     std::vector<std::string>& urls = out[matrix.usernames[user]];
+                     for (size_t site = 0; site < matrix.site_count(); site++) {
+                         if (matrix.at(user, site) == SiteStatus::Found) {
+                             urls.push_back(matrix.catalog->sites[site].url(matrix.usernames[user]));
+                         }
+                     }
+                 }
+                 return out;
+             },
+             "Returns {username: [profile URLs found]}")
+        .def_buffer([](SherlockMatrix& matrix) {
+            py::ssize_t columns = (py::ssize_t)matrix.site_count();
+            return py::buffer_info(matrix.cells.data(), 1, py::format_descriptor<uint8_t>::format(), 2,
+                                   {(py::ssize_t)matrix.usernames.size(), columns}, {columns, (py::ssize_t)1},
+                                   /*readonly=*/true);
+        });
+
+    // --- Username candidates from real names ---
+    py::class_<VariantOptions>(m, "VariantOptions")
+        .def(py::init([](size_t max_candidates, bool separators, bool initials, bool numeric_suffixes,
+                         bool transliterate) {
+                 VariantOptions options;
+                 options.max_candidates = max_candidates;
+                 options.separators = separators;
+                 options.initials = initials;
+                 options.numeric_suffixes = numeric_suffixes;
+                 options.transliterate = transliterate;
+                 return options;
+             }),
+             py::arg("max_candidates") = VariantOptions().max_candidates, py::arg("separators") = true,
+             py::arg("initials") = true, py::arg("numeric_suffixes") = true, py::arg("transliterate") = true)
+        .def_readwrite("max_candidates", &VariantOptions::max_candidates)
+        .def_readwrite("separators", &VariantOptions::separators)
+        .def_readwrite("initials", &VariantOptions::initials)
+        .def_readwrite("numeric_suffixes", &VariantOptions::numeric_suffixes)
+        .def_readwrite("transliterate", &VariantOptions::transliterate);
+
+    py::class_<UsernameCandidate>(m, "UsernameCandidate")
+        .def_readonly("username", &UsernameCandidate::username)
+        .def_readonly("score", &UsernameCandidate::score)
+        .def_readonly("name", &UsernameCandidate::name)
+        .def("__repr__", [](const UsernameCandidate& c) {
+            return "<UsernameCandidate " + c.username + " " + std::to_string(c.score) + ">";
+        });
+
+    m.def("username_variants", &username_variants,
+          "Expands a real name into likely usernames, best first",
+          py::arg("full_name"), py::arg("options") = VariantOptions());
+
+    py::class_<NameSweep>(m, "NameSweep")
+        .def_readonly("names", &NameSweep::names)
+        .def_readonly("candidates", &NameSweep::candidates)
+        .def_readonly("matrix", &NameSweep::matrix)
+        .def("profiles", [](const NameSweep& sweep) {
+                 // name -> {candidate username: [profile URLs found]}, only candidates with hits
+                 std::map<std::string, std::map<std::string, std::vector<std::string>>> out;
+                 const SherlockMatrix& matrix = sweep.matrix;
+                 for (const std::string& name : sweep.names) out[name];
+                 for (size_t user = 0; user < sweep.candidates.size(); user++) {
+                     const UsernameCandidate& candidate = sweep.candidates[user];
+                     std::vector<std::string> urls;
+                     for (size_t site = 0; site < matrix.site_count(); site++) {
+                         if (matrix.at(user, site) == SiteStatus::Found) {
+                             urls.push_back(matrix.catalog->sites[site].url(candidate.username));
+                         }
+                     }
+                     if (!urls.empty()) out[sweep.names[candidate.name]][candidate.username] = std::move(urls);
+                 }
+                 return out;
+             },
+             "Returns {name: {username: [profile URLs found]}}");
+
+    m.def("sherlock_names", &sherlock_names,
+          "Generates username candidates for each name and checks them all against every site in one run",
+          py::arg("names"), py::arg("options") = VariantOptions(), py::call_guard<py::gil_scoped_release>());
+
+    // --- Presence cache ---
+    // Every sweep answers from it while a verdict is fresh:
+    //   configure_presence_cache(PresenceOptions(found_ttl_seconds=3600))
+    py::class_<PresenceOptions>(m, "PresenceOptions")
+        .def(py::init([](double found_ttl_seconds, double not_found_ttl_seconds, double error_ttl_seconds) {
+                 PresenceOptions options;
+                 options.found_ttl_seconds = found_ttl_seconds;
+                 options.not_found_ttl_seconds = not_found_ttl_seconds;
+                 options.error_ttl_seconds = error_ttl_seconds;
+                 return options;
+             }),
+             py::arg("found_ttl_seconds") = PresenceOptions().found_ttl_seconds,
+             py::arg("not_found_ttl_seconds") = PresenceOptions().not_found_ttl_seconds,
+             py::arg("error_ttl_seconds") = PresenceOptions().error_ttl_seconds)
+        .def_readwrite("found_ttl_seconds", &PresenceOptions::found_ttl_seconds)
+        .def_readwrite("not_found_ttl_seconds", &PresenceOptions::not_found_ttl_seconds)
+        .def_readwrite("error_ttl_seconds", &PresenceOptions::error_ttl_seconds);
+
+    m.def("configure_presence_cache", [](const PresenceOptions& options) { PresenceCache::instance().configure(options); },
+          "Sets how long found / not-found / error verdicts are answered from the presence cache (0 = never)",
+          py::arg("options"));
+    m.def("presence_cache_options", [] { return PresenceCache::instance().options(); });
+    m.def("clear_presence_cache", [] { PresenceCache::instance().clear(); },
+          "Forgets every cached username verdict", py::call_guard<py::gil_scoped_release>());
+    m.def("presence_cache_stats", [] { return PresenceCache::instance().stats(); },
+          "Presence cache counters (hits, misses, stores, entries, capacity)");
+
+    m.def("probe_methods", &probe_methods,
+          "Hosts where HEAD was refused and the probe method that answered instead (RANGE or GET)");
+
+    m.def("site_latency_stats", [] { return SiteLatency::instance().stats(); },
+          "Per-site answer-time history behind the adaptive timeouts (samples, p50_ms, p99_ms, timeouts_in_a_row)");
+
+    m.def("sherlock_matrix", &sherlock_matrix,
+          "Checks several candidate usernames against every catalog site in one host-grouped run",
+          py::arg("usernames"), py::call_guard<py::gil_scoped_release>());
+
+    // --- Awaitable versions ---
+    // Must be called from a running asyncio loop; each returns an asyncio.Future.
+    // A future cancelled by the caller is left alone when the result lands.
+    g_resolve_future = new py::object(py::cpp_function([](py::object future, py::object value) {
+        if (!future.attr("done")().cast<bool>()) future.attr("set_result")(value);
+    }));
+
+    m.def("scrape_async", [](const std::string& url, const CacheOptions& cache) {
+              auto target = new_async_target();
+              py::object future = target->future;
+              ScrapeRequest request;
+              request.url = url;
+              py::gil_scoped_release release;
+              ResponseCache::instance().submit(std::move(request), cache, [target](ScrapeResult&& response) {
+                  ScrapeResultPtr result = std::make_shared<ScrapeResult>(std::move(response));
+                  target->resolve([result] { return py::cast(result); });
+              });
+              return future;
+          },
+          "Awaitable scrape of one URL; resolves to a ScrapeResult",
+          py::arg("url"), py::arg("cache") = CacheOptions());
+
+    m.def("parallel_scrape_async", [](const std::vector<std::string>& urls, const CacheOptions& cache) {
+              auto target = new_async_target();
+
+              struct Batch {
+                  std::mutex mutex;
+                  std::map<std::string, ScrapeResultPtr> results;
+                  size_t remaining = 0;
+              };
+              auto batch = std::make_shared<Batch>();
+              batch->remaining = urls.size();
+              if (urls.empty()) {
+                  target->future.attr("set_result")(py::dict());
+                  return target->future;
+              }
+
+              py::object future = target->future;
+              py::gil_scoped_release release;
+              for (const auto& url : urls) {
+                  ScrapeRequest request;
+                  request.url = url;
+                  ResponseCache::instance().submit(std::move(request), cache, [target, batch](ScrapeResult&& response) {
+                      ScrapeResultPtr result = std::make_shared<ScrapeResult>(std::move(response));
+                      bool last;
+                      {
+                          std::lock_guard<std::mutex> lock(batch->mutex);
+                          batch->results[result->url] = result;
+                          last = --batch->remaining == 0;
+                      }
+                      if (last) target->resolve([batch] { return py::cast(batch->results); });
+                  });
+              }
+              return future;
+          },
+          "Awaitable parallel_scrape; resolves to dict[url, ScrapeResult]",
+          py::arg("urls"), py::arg("cache") = CacheOptions());
+
+    m.def("parallel_sherlock_async", [](const std::string& username) {
+              auto target = new_async_target();
+              py::object future = target->future;
+              py::gil_scoped_release release;
+              parallel_sherlock_async(username, [target](std::vector<std::string>&& found) {
+                  target->resolve([found = std::move(found)] { return py::cast(found); });
+              });
+              return future;
+          },
+          "Awaitable parallel_sherlock; resolves to the list of profile URLs found",
           py::arg("username"));
+
+    // --- Engine tuning ---
+    py::class_<HostLimits>(m, "HostLimits")
+        .def(py::init<>())
+        .def(py::init([](double rate_per_second, double burst, long max_in_flight) {
+                 HostLimits limits;
+                 limits.rate_per_second = rate_per_second;
+                 limits.burst = burst;
+                 limits.max_in_flight = max_in_flight;
+                 return limits;
+             }),
+             py::arg("rate_per_second") = 0.0, py::arg("burst") = 1.0, py::arg("max_in_flight") = 16)
+        .def_readwrite("rate_per_second", &HostLimits::rate_per_second)
+        .def_readwrite("burst", &HostLimits::burst)
+        .def_readwrite("max_in_flight", &HostLimits::max_in_flight);
+
+    py::class_<EngineConfig>(m, "EngineConfig")
+        .def(py::init<>())
+        .def_readwrite("max_in_flight", &EngineConfig::max_in_flight)
+        .def_readwrite("timeout_ms", &EngineConfig::timeout_ms)
+        .def_readwrite("http2", &EngineConfig::http2)
+        .def_readwrite("http2_prior_knowledge", &EngineConfig::http2_prior_knowledge)
+        .def_readwrite("max_host_connections", &EngineConfig::max_host_connections)
+        .def_readwrite("max_streams_per_connection", &EngineConfig::max_streams_per_connection)
+        .def_readwrite("default_host_limits", &EngineConfig::default_host_limits);
+
+    m.def("engine_config", [] { return ScrapeEngine::instance().config(); },
+          "Returns a copy of the scrape engine's current settings");
+
+    m.def("configure_engine", [](const EngineConfig& config) { ScrapeEngine::instance().configure(config); },
+          "Applies new scrape engine settings (in-flight window, timeout, HTTP/2, per-host cap)",
+          py::arg("config"), py::call_guard<py::gil_scoped_release>());
+
+    m.def("set_host_limits", [](const std::string& host, const HostLimits& limits) {
+              ScrapeEngine::instance().set_host_limits(host, limits);
+          },
+          "Overrides the rate / in-flight limits for one host, e.g. set_host_limits('www.google.com', HostLimits(2, 5, 4))",
+          py::arg("host"), py::arg("limits"), py::call_guard<py::gil_scoped_release>());
+
+    m.def("clear_host_limits", [](const std::string& host) { ScrapeEngine::instance().clear_host_limits(host); },
+          "Puts a host back on the engine's default limits",
+          py::arg("host"), py::call_guard<py::gil_scoped_release>());
+
+    m.def("connection_stats", [] { return ConnectionPool::instance().stats(); },
+          "Connection-reuse counters for every request made through the C++ core");
+
+    m.def("buffer_stats", [] { return BufferPool::instance().stats(); },
+          "Body buffer pool counters (buffers taken, recycled, idle)");
+
+    m.def("reset_connection_stats", [] { ConnectionPool::instance().reset_stats(); },
+          "Zeroes the connection-reuse counters");
+
+    py::class_<HarvestedEntity>(m, "HarvestedEntity")
+        .def_readonly("value", &HarvestedEntity::value)
+        .def_readonly("sources", &HarvestedEntity::sources)
+        .def_readonly("mentions", &HarvestedEntity::mentions)
+        .def("__repr__", [](const HarvestedEntity& e) {
+            return "<HarvestedEntity " + e.value + " sources=" + std::to_string(e.sources) +
+                   " mentions=" + std::to_string(e.mentions) + ">";
+        });
+
+    // emails / subdomains: normalized, unique, most sources first
     py::class_<HarvesterResults>(m, "HarvesterResults")
         .def(py::init<>())
         .def_readonly("emails", &HarvesterResults::emails)
@@ -38,5 +664,46 @@ PYBIND11_MODULE(argus_cpp_core, m) {
     // --- NEW: Expose the parallel_harvester function ---
     m.def("parallel_harvester", &parallel_harvester,
           "Scrapes search engines for emails and subdomains in parallel",
-          py::arg("domain"));
+          py::arg("domain"), py::arg("search_url") = "https://www.google.com/search?q=",
+          py::call_guard<py::gil_scoped_release>());
+
+    py::class_<HarvestOptions>(m, "HarvestOptions")
+        .def(py::init([](size_t max_pages_in_flight, size_t max_page_bytes) {
+                 HarvestOptions options;
+                 options.max_pages_in_flight = max_pages_in_flight;
+                 options.max_page_bytes = max_page_bytes;
+                 return options;
+             }),
+             py::arg("max_pages_in_flight") = 64, py::arg("max_page_bytes") = 8u << 20)
+        .def_readwrite("max_pages_in_flight", &HarvestOptions::max_pages_in_flight)
+        .def_readwrite("max_page_bytes", &HarvestOptions::max_page_bytes);
+
+    m.def("normalize_host", &normalize_host,
+          "Lower-cases a host name, strips trailing dots and IDNA-encodes non-ASCII labels",
+          py::arg("host"));
+
+    m.def("harvest_pages", &harvest_pages,
+          "Fetches the given pages and pulls out emails and subdomains of `domain`, parsing each page "
+          "as soon as it arrives. At most options.max_pages_in_flight pages are held at once.",
+          py::arg("urls"), py::arg("domain"), py::arg("options") = HarvestOptions(),
+          py::call_guard<py::gil_scoped_release>());
+
+    py::class_<ExtractedEntities>(m, "ExtractedEntities")
+        .def(py::init<>())
+        .def_readonly("emails", &ExtractedEntities::emails)
+        .def_readonly("subdomains", &ExtractedEntities::subdomains)
+        .def_readonly("urls", &ExtractedEntities::urls)
+        .def_readonly("ipv4", &ExtractedEntities::ipv4)
+        .def_readonly("ipv6", &ExtractedEntities::ipv6);
+
+    m.def("extract_entities",
+          [](const std::string& text, const std::vector<std::string>& kinds, const std::string& domain) {
+              uint32_t mask = parse_entity_kinds(kinds);
+              py::gil_scoped_release release;
+              return extract_entities(text.data(), text.size(), mask, domain);
+          },
+          "Pulls the requested entity kinds ('emails', 'subdomains', 'urls', 'ipv4', 'ipv6', or 'all') "
+          "out of text. One pass cuts the text into candidate runs; each requested kind then "
+          "scans those runs. 'subdomains' needs the target domain.",
+          py::arg("text"), py::arg("kinds") = std::vector<std::string>{"all"}, py::arg("domain") = "");
 }
\ No newline at end of file
@@ -0,0 +1,107 @@
+#define NOMINMAX
+#include "body_buffer.h"
+#include <algorithm>
+
+// Every body starts with at least this much room; most search pages fit.
+static const size_t kInitialCapacity = 64 * 1024;
+
+// Never trust a Content-Length beyond this for pre-sizing
+static const size_t kMaxReserve = 64u << 20;
+
+BodyBuffer::~BodyBuffer() {
+    if (borrowed_) BufferPool::instance().give(std::move(storage_));
+}
+
+BodyBuffer::BodyBuffer(BodyBuffer&& other) noexcept
+    : storage_(std::move(other.storage_)), borrowed_(other.borrowed_) {
+    other.storage_.clear();
+    other.borrowed_ = false;
+}
+
+BodyBuffer& BodyBuffer::operator=(BodyBuffer&& other) noexcept {
+    if (this != &other) {
+        if (borrowed_) BufferPool::instance().give(std::move(storage_));
+        storage_ = std::move(other.storage_);
+        borrowed_ = other.borrowed_;
+        other.storage_.clear();
+        other.borrowed_ = false;
+    }
+    return *this;
+}
+
+void BodyBuffer::borrow(size_t hint) {
+    storage_ = BufferPool::instance().take(hint);
+    borrowed_ = true;
+}
+
+void BodyBuffer::append(const char* data, size_t length) {
+    if (!borrowed_) borrow(length);
+    storage_.append(data, length);
+}
+
+char* BodyBuffer::grow(size_t length) {
+    if (!borrowed_) borrow(length);
+    size_t offset = storage_.size();
+    storage_.resize(offset + length);
+    return &storage_[offset];
+}
+
+void BodyBuffer::reserve(size_t capacity) {
+    capacity = std::min(capacity, kMaxReserve);
+    if (!borrowed_) {
+        borrow(capacity);
+        return;
+    }
+    if (capacity > storage_.capacity()) storage_.reserve(capacity);
+}
+
+BufferPool& BufferPool::instance() {
+    static BufferPool* pool = new BufferPool();
+    return *pool;
+}
+
+std::string BufferPool::take(size_t hint) {
+    taken_++;
+    hint = std::max(hint, kInitialCapacity);
+
+    std::string storage;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!idle_.empty()) {
+            // First idle buffer that already fits, otherwise the most recently returned
+            auto pick = std::find_if(idle_.begin(), idle_.end(),
+                                     [&](const std::string& s) { return s.capacity() >= hint; });
+            if (pick == idle_.end()) pick = idle_.end() - 1;
+            storage = std::move(*pick);
+            idle_.erase(pick);
+            recycled_++;
+        }
+    }
+
+    storage.clear();
+    if (storage.capacity() < hint) storage.reserve(hint);
+    return storage;
+}
+
+void BufferPool::give(std::string&& storage) {
+    if (storage.capacity() > kMaxRetainedCapacity) return; // let it go
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idle_.size() < kMaxPooled) {
+        storage.clear();
+        idle_.push_back(std::move(storage));
+    }
+}
+
+std::map<std::string, unsigned long long> BufferPool::stats() {
+    std::map<std::string, unsigned long long> out;
+    out["buffers_taken"] = taken_;
+    out["buffers_recycled"] = recycled_;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    unsigned long long idle_bytes = 0;
+    for (const auto& storage : idle_) idle_bytes += storage.capacity();
+    out["idle_buffers"] = idle_.size();
+    out["idle_bytes"] = idle_bytes;
+    return out;
+}
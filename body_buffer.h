@@ -0,0 +1,66 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+
+// --- Pooled Body Buffers ---
+// A response body is written once by curl, read many times (Python via the
+// buffer protocol, the extractors in place) and then thrown away. Instead of
+// letting every page grow a fresh std::string from nothing, BodyBuffer
+// borrows already-grown storage from BufferPool and gives it back when the
+// owning ScrapeResult dies, so a harvest batch recycles the same few
+// megabytes instead of reallocating them page after page.
+class BodyBuffer {
+public:
+    BodyBuffer() = default;
+    ~BodyBuffer();
+
+    BodyBuffer(BodyBuffer&& other) noexcept;
+    BodyBuffer& operator=(BodyBuffer&& other) noexcept;
+    BodyBuffer(const BodyBuffer&) = delete;
+    BodyBuffer& operator=(const BodyBuffer&) = delete;
+
+    void append(const char* data, size_t length);
+    void reserve(size_t capacity);   // e.g. from Content-Length
+
+    // Appends `length` bytes and returns where they start, for producers
+    // (decompressors) that want to write straight into the buffer.
+    char* grow(size_t length);
+
+    const char* data() const { return storage_.data(); }
+    size_t size() const { return storage_.size(); }
+    bool empty() const { return storage_.empty(); }
+
+    std::string str() const { return storage_; } // an explicit copy, for the rare caller that needs one
+
+private:
+    void borrow(size_t hint);
+
+    std::string storage_;
+    bool borrowed_ = false;
+};
+
+class BufferPool {
+public:
+    static BufferPool& instance();
+
+    // Storage with at least `hint` bytes of capacity, empty.
+    std::string take(size_t hint);
+    void give(std::string&& storage);
+
+    std::map<std::string, unsigned long long> stats();
+
+private:
+    BufferPool() = default;
+
+    static const size_t kMaxPooled = 64;                   // idle buffers kept around
+    static const size_t kMaxRetainedCapacity = 8u << 20;   // bigger ones go back to the allocator
+
+    std::mutex mutex_;
+    std::vector<std::string> idle_;
+
+    std::atomic<unsigned long long> taken_{0};
+    std::atomic<unsigned long long> recycled_{0};
+};
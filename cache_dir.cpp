@@ -0,0 +1,25 @@
+#include "cache_dir.h"
+#include <cstdlib>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+std::string cache_path(const std::string& name) {
+    fs::path directory;
+    if (const char* env = std::getenv("ARGUS_CACHE_DIR")) {
+        directory = env;
+    } else {
+#ifdef _WIN32
+        if (const char* local = std::getenv("LOCALAPPDATA")) directory = fs::path(local) / "argus";
+#else
+        if (const char* xdg = std::getenv("XDG_CACHE_HOME")) directory = fs::path(xdg) / "argus";
+        else if (const char* home = std::getenv("HOME")) directory = fs::path(home) / ".cache" / "argus";
+#endif
+    }
+    if (directory.empty()) return name;
+
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec) return name;
+    return (directory / name).string();
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include <string>
+
+// --- Per-user Cache Directory ---
+// Where the core keeps state between runs: $ARGUS_CACHE_DIR, else
+// %LOCALAPPDATA%\argus, $XDG_CACHE_HOME/argus or ~/.cache/argus. Runs from
+// different directories share one copy and nothing lands in the source tree.
+
+// `name` inside the cache directory, which is created if needed. Falls back
+// to `name` itself (the working directory) when there is no usable home.
+std::string cache_path(const std::string& name);
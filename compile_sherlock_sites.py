@@ -0,0 +1,113 @@
+# Compiles sherlock_sites.json (from export_sherlock_sites.py) into
+# sherlock_sites.bin, the catalog the C++ core maps at startup instead of
+# parsing JSON. Usage: python compile_sherlock_sites.py [in.json] [out.bin]
+#
+# Layout, little-endian (must match sherlock_catalog.cpp):
+#   header   magic "AGS1", u32 version, u32 site/host/message/code counts,
+#            u32 pool size, u32 reserved
+#   hosts    (u32 offset, u32 length) into the pool, by host id
+#   sites    fixed 48-byte records, in name order
+#   messages (u32 offset, u32 length), each site's run is contiguous
+#   codes    i32, each site's run is contiguous
+#   pool     every string, UTF-8, deduplicated
+import json
+import os
+import struct
+import sys
+
+MAGIC = b'AGS1'
+VERSION = 1
+PLACEHOLDER = '{username}'
+ERROR_TYPES = {'status_code': 0, 'message': 1, 'response_url': 2}
+
+HEADER = struct.Struct('<4s7I')
+STRING_REF = struct.Struct('<II')
+SITE = struct.Struct('<7IBBH4I')
+CODE = struct.Struct('<i')
+
+
+class StringPool:
+    def __init__(self):
+        self.data = bytearray()
+        self.offsets = {}
+
+    def add(self, text):
+        raw = text.encode('utf-8')
+        if raw not in self.offsets:
+            self.offsets[raw] = len(self.data)
+            self.data += raw
+        return self.offsets[raw], len(raw)
+
+
+def host_part(url_template):
+    # "https://{username}.tumblr.com/" -> "{username}.tumblr.com", lower-cased
+    start = url_template.find('://')
+    start = 0 if start == -1 else start + 3
+    end = len(url_template)
+    for stop in '/?#':
+        at = url_template.find(stop, start)
+        if at != -1:
+            end = min(end, at)
+    return url_template[start:end].lower()
+
+
+def as_list(value):
+    return value if isinstance(value, list) else [value]
+
+
+def compile_catalog(sites):
+    pool = StringPool()
+    hosts, host_ids = [], {}
+    records, messages, codes = [], [], []
+
+    # Same rules as the JSON loader, so both paths build the same catalog
+    for name in sorted(sites):
+        info = sites[name]
+        url_template = info.get('url') if isinstance(info, dict) else None
+        if not isinstance(url_template, str) or PLACEHOLDER not in url_template:
+            continue
+        prefix, suffix = url_template.split(PLACEHOLDER, 1)
+
+        site_messages = [m for m in as_list(info.get('errorMsg', [])) if isinstance(m, str) and m]
+        site_codes = [c for c in as_list(info.get('errorCode', [])) if isinstance(c, int) and not isinstance(c, bool)]
+        error_type = ERROR_TYPES.get(info.get('errorType'), 0)
+        if error_type == ERROR_TYPES['message'] and not site_messages:
+            error_type = ERROR_TYPES['status_code']
+
+        host = host_part(url_template)
+        if host not in host_ids:
+            host_ids[host] = len(hosts)
+            hosts.append(pool.add(host))
+
+        records.append(SITE.pack(*pool.add(name), *pool.add(prefix), *pool.add(suffix), host_ids[host],
+                                 error_type, PLACEHOLDER in suffix, 0,
+                                 len(messages), len(site_messages), len(codes), len(site_codes)))
+        messages.extend(pool.add(m) for m in site_messages)
+        codes.extend(site_codes)
+
+    out = bytearray(HEADER.pack(MAGIC, VERSION, len(records), len(hosts), len(messages), len(codes),
+                                len(pool.data), 0))
+    for ref in hosts:
+        out += STRING_REF.pack(*ref)
+    for record in records:
+        out += record
+    for ref in messages:
+        out += STRING_REF.pack(*ref)
+    for code in codes:
+        out += CODE.pack(code)
+    out += pool.data
+    return bytes(out), len(records)
+
+
+if __name__ == '__main__':
+    source = sys.argv[1] if len(sys.argv) > 1 else 'sherlock_sites.json'
+    target = sys.argv[2] if len(sys.argv) > 2 else 'sherlock_sites.bin'
+
+    with open(source, encoding='utf-8') as f:
+        data, count = compile_catalog(json.load(f))
+    # Write then rename, so a running process never maps half a file
+    with open(target + '.tmp', 'wb') as f:
+        f.write(data)
+    os.replace(target + '.tmp', target)
+
+    print(f"Compiled {count} sites into {target} ({len(data)} bytes)")
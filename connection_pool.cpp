@@ -0,0 +1,118 @@
+#define NOMINMAX
+#include "connection_pool.h"
+
+static const char* kUserAgent = "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/91.0.4472.124 Safari/537.36";
+
+ConnectionPool& ConnectionPool::instance() {
+    // Leaked on purpose, same as the engine: handles may still be in use by
+    // the loop thread while static destructors run.
+    static ConnectionPool* pool = new ConnectionPool();
+    return *pool;
+}
+
+ConnectionPool::ConnectionPool() {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    share_ = curl_share_init();
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &ConnectionPool::lock_share);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &ConnectionPool::unlock_share);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+}
+
+void ConnectionPool::lock_share(CURL*, curl_lock_data data, curl_lock_access, void* userptr) {
+    static_cast<ConnectionPool*>(userptr)->share_locks_[data].lock();
+}
+
+void ConnectionPool::unlock_share(CURL*, curl_lock_data data, void* userptr) {
+    static_cast<ConnectionPool*>(userptr)->share_locks_[data].unlock();
+}
+
+void ConnectionPool::apply_defaults(CURL* curl) {
+    curl_easy_setopt(curl, CURLOPT_SHARE, share_);
+    curl_easy_setopt(curl, CURLOPT_USERAGENT, kUserAgent);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curl, CURLOPT_DNS_CACHE_TIMEOUT, 300L);
+}
+
+CURL* ConnectionPool::acquire() {
+    CURL* curl = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        if (!idle_.empty()) {
+            curl = idle_.back();
+            idle_.pop_back();
+        }
+    }
+
+    if (curl) {
+        handles_reused_++;
+    } else {
+        curl = curl_easy_init();
+        if (!curl) return nullptr;
+        handles_created_++;
+    }
+
+    apply_defaults(curl);
+    return curl;
+}
+
+void ConnectionPool::release(CURL* curl) {
+    if (!curl) return;
+
+    // Reset drops per-request options (including CURLOPT_SHARE, re-applied on
+    // acquire) but the shared caches live on in share_.
+    curl_easy_reset(curl);
+
+    std::lock_guard<std::mutex> lock(idle_mutex_);
+    if (idle_.size() < kMaxIdleHandles) {
+        idle_.push_back(curl);
+        return;
+    }
+    curl_easy_cleanup(curl);
+}
+
+void ConnectionPool::record(CURL* curl) {
+    long new_connects = 0;
+    long http_version = 0;
+    curl_off_t appconnect_us = 0;
+    curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &new_connects);
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &appconnect_us);
+    curl_easy_getinfo(curl, CURLINFO_HTTP_VERSION, &http_version);
+
+    requests_++;
+    if (http_version == CURL_HTTP_VERSION_2_0) http2_responses_++;
+    if (new_connects > 0) {
+        connections_opened_ += new_connects;
+        // A non-zero appconnect time on a fresh connection means a TLS handshake ran
+        if (appconnect_us > 0) tls_handshakes_++;
+    } else {
+        connections_reused_++;
+    }
+}
+
+std::map<std::string, unsigned long long> ConnectionPool::stats() {
+    std::map<std::string, unsigned long long> out;
+    out["requests"] = requests_;
+    out["connections_opened"] = connections_opened_;
+    out["connections_reused"] = connections_reused_;
+    out["tls_handshakes"] = tls_handshakes_;
+    out["http2_responses"] = http2_responses_;
+    out["handles_created"] = handles_created_;
+    out["handles_reused"] = handles_reused_;
+    return out;
+}
+
+void ConnectionPool::reset_stats() {
+    requests_ = 0;
+    connections_opened_ = 0;
+    connections_reused_ = 0;
+    tls_handshakes_ = 0;
+    http2_responses_ = 0;
+    handles_created_ = 0;
+    handles_reused_ = 0;
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <curl/curl.h>
+
+// --- The Connection Pool ---
+// Process-wide home for everything worth keeping between requests:
+//   * a stack of idle easy handles (curl_easy_reset keeps their buffers)
+//   * one CURLSH object sharing the DNS cache, the connection cache and
+//     TLS session IDs between every pooled handle
+// so a dork batch that hits google.com five times resolves, connects and
+// handshakes once. Lives until the process exits, across Python calls.
+//
+// libcurl does not support using a shared connection cache from several
+// threads at once, so pooled handles are only ever run by the ScrapeEngine's
+// loop thread; code that wants a blocking fetch submits to the engine and
+// waits (see scrape_url).
+class ConnectionPool {
+public:
+    static ConnectionPool& instance();
+
+    // A handle with the share object and the standard options applied, for
+    // the engine's loop thread. Give it back with release() once the
+    // transfer is over.
+    CURL* acquire();
+    void release(CURL* curl);
+
+    // Feed the counters from a finished transfer (call before release()).
+    void record(CURL* curl);
+
+    // Counters for measuring the reuse gain; reset_stats() zeroes them.
+    std::map<std::string, unsigned long long> stats();
+    void reset_stats();
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+private:
+    ConnectionPool();
+
+    void apply_defaults(CURL* curl);
+
+    static void lock_share(CURL* curl, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void unlock_share(CURL* curl, curl_lock_data data, void* userptr);
+
+    static const size_t kMaxIdleHandles = 256;
+
+    CURLSH* share_ = nullptr;
+    std::mutex share_locks_[CURL_LOCK_DATA_LAST];
+
+    std::mutex idle_mutex_;
+    std::vector<CURL*> idle_;
+
+    std::atomic<unsigned long long> requests_{0};
+    std::atomic<unsigned long long> connections_opened_{0};
+    std::atomic<unsigned long long> connections_reused_{0};
+    std::atomic<unsigned long long> tls_handshakes_{0};
+    std::atomic<unsigned long long> http2_responses_{0};
+    std::atomic<unsigned long long> handles_created_{0};
+    std::atomic<unsigned long long> handles_reused_{0};
+};
@@ -2,6 +2,7 @@
 
 import json
 import threading
+import time
 from concurrent.futures import ThreadPoolExecutor
 from core_utils import osint_utils
 import re
@@ -19,6 +20,7 @@ class DossierManager:
         self.speak = speak_func
         self.send_to_ui = ui_func
         self.report = {"query": query, "intel": {}}
+        self._progress_sent_at = 0.0
         
         # Simple regex to detect query type
         self.is_email = re.match(r"[^@]+@[^@]+\.[^@]+", query)
@@ -46,7 +48,8 @@ class DossierManager:
                     futures[executor.submit(osint_utils.check_breaches, self.query)] = "breach_check"
                 
                 if self.is_username:
-                    futures[executor.submit(osint_utils.search_socials, self.query)] = "social_search"
+                    futures[executor.submit(osint_utils.search_socials, self.query,
+                                            self._forward_sweep_batch)] = "social_search"
                     
                 if self.is_domain:
                     futures[executor.submit(osint_utils.find_domain_intel, self.query)] = "domain_intel"
@@ -76,6 +79,24 @@ class DossierManager:
 
         self.finish_dossier()
 
+    def _forward_sweep_batch(self, batch):
+        """
+        Forwards one batch of live username-sweep events to the UI, so found
+        profiles show up while the rest of the dossier is still running.
+        Batches with no hits only update the progress bar, at most every 100 ms.
+        """
+        now = time.monotonic()
+        if not batch.found and not batch.finished and now - self._progress_sent_at < 0.1:
+            return
+        self._progress_sent_at = now
+        self.send_to_ui("dossier_progress", {
+            "query": self.query,
+            "tool": "social_search",
+            "done": batch.done,
+            "total": batch.total,
+            "found": [{"site": hit.site, "url": hit.url} for hit in batch.found]
+        })
+
     def finish_dossier(self):
         """
         Synthesizes the final report and speaks it.
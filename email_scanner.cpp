@@ -0,0 +1,109 @@
+#include "email_scanner.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARGUS_EMAIL_SSE2 1
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// Character classes from the regex, one bit each
+enum : unsigned char { kLocal = 1, kDomain = 2, kAlpha = 4 };
+
+struct CharClasses {
+    unsigned char bits[256] = {};
+
+    CharClasses() {
+        for (int c = 0; c < 256; c++) {
+            bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+            bool alnum = alpha || (c >= '0' && c <= '9');
+            if (alnum || c == '.' || c == '_' || c == '%' || c == '+' || c == '-') bits[c] |= kLocal;
+            if (alnum || c == '.' || c == '-') bits[c] |= kDomain;
+            if (alpha) bits[c] |= kAlpha;
+        }
+    }
+};
+
+static const CharClasses kClasses;
+
+static inline bool is(unsigned char c, unsigned char cls) { return (kClasses.bits[c] & cls) != 0; }
+
+#ifdef ARGUS_EMAIL_SSE2
+static inline int lowest_bit(unsigned mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+// Offset of the next '@' at or after `from`, or size_ if there is none
+size_t EmailScanner::find_at(size_t from) const {
+#ifdef ARGUS_EMAIL_SSE2
+    const __m128i at = _mm_set1_epi8('@');
+    size_t i = from;
+    for (; i + 16 <= size_; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data_ + i));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, at));
+        if (mask) return i + lowest_bit(mask);
+    }
+    for (; i < size_; i++) {
+        if (data_[i] == '@') return i;
+    }
+    return size_;
+#else
+    if (from >= size_) return size_;
+    const void* hit = std::memchr(data_ + from, '@', size_ - from);
+    return hit ? (size_t)(static_cast<const char*>(hit) - data_) : size_;
+#endif
+}
+
+bool EmailScanner::next(size_t& begin, size_t& end) {
+    const unsigned char* text = reinterpret_cast<const unsigned char*>(data_);
+    while (pos_ < size_) {
+        size_t at = find_at(pos_);
+        if (at >= size_) break;
+        pos_ = at + 1;
+
+        // Local part: the run of local characters right before the '@'
+        size_t start = at;
+        while (start > floor_ && is(text[start - 1], kLocal)) start--;
+        if (start == at) continue;
+
+        // Domain: the regex's greedy [a-zA-Z0-9.-]+ backs off to the last dot
+        // with at least one character before it and two letters after it
+        size_t run_end = at + 1;
+        while (run_end < size_ && is(text[run_end], kDomain)) run_end++;
+
+        size_t match_end = 0;
+        for (size_t dot = run_end; dot-- > at + 2;) {
+            if (text[dot] != '.') continue;
+            size_t letters = dot + 1;
+            while (letters < run_end && is(text[letters], kAlpha)) letters++;
+            if (letters - dot > 2) {
+                match_end = letters;
+                break;
+            }
+        }
+        if (!match_end) continue;
+
+        begin = start;
+        end = match_end;
+        floor_ = pos_ = match_end;
+        return true;
+    }
+    pos_ = size_;
+    return false;
+}
+
+std::vector<std::string> find_emails(const char* data, size_t size) {
+    std::vector<std::string> out;
+    EmailScanner scanner(data, size);
+    for (size_t begin, end; scanner.next(begin, end);) out.emplace_back(data + begin, end - begin);
+    return out;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// --- Email Scanner ---
+// A hand-written replacement for the harvester's
+//     [a-zA-Z0-9._%+-]+@[a-zA-Z0-9.-]+\.[a-zA-Z]{2,}
+// std::regex backtracks through every local-part character on every page
+// and recurses per character, so it's slow and a long enough run can blow
+// the stack. Here '@' is located 16 bytes at a time with SSE2 (memchr
+// elsewhere), and only around each '@' are the local part and the domain
+// expanded with 256-entry class tables. Matches are exactly the regex's,
+// leftmost first and non-overlapping.
+class EmailScanner {
+public:
+    EmailScanner(const char* data, size_t size) : data_(data), size_(size) {}
+
+    // The next address, as [begin, end) offsets into the buffer. False once
+    // the buffer is exhausted.
+    bool next(size_t& begin, size_t& end);
+
+private:
+    size_t find_at(size_t from) const;
+
+    const char* data_;
+    size_t size_;
+    size_t pos_ = 0;        // where the next '@' search starts
+    size_t floor_ = 0;      // end of the previous match; a local part can't reach behind it
+};
+
+// Every address in the buffer, in order, repeats included.
+std::vector<std::string> find_emails(const char* data, size_t size);
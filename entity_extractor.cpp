@@ -0,0 +1,282 @@
+#include "entity_extractor.h"
+#include "email_scanner.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+// A run longer than this is flushed even if the chunk ended inside it
+// (base64 blobs); it only matters for input that arrives in chunks.
+static const size_t kMaxCarry = 64 * 1024;
+
+// --- The shared class table ---
+enum : unsigned char {
+    kRun = 1,       // can appear inside a URL, address or host
+    kHost = 2,      // host name characters (UTF-8 bytes included, for IDN hosts)
+    kDigit = 4,
+    kHex = 8,
+    kWord = 16,     // letters, digits, '_': an IPv6 literal can't touch these
+};
+
+struct EntityClasses {
+    unsigned char bits[256] = {};
+
+    EntityClasses() {
+        for (int c = 0; c < 256; c++) {
+            bool alpha = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+            bool digit = c >= '0' && c <= '9';
+            if (alpha || digit || c >= 0x80 || std::strchr("-._~%+@:/?#[]!$&*=;,", c)) bits[c] |= kRun;
+            if (alpha || digit || c >= 0x80 || c == '.' || c == '-') bits[c] |= kHost;
+            if (digit) bits[c] |= kDigit;
+            if (digit || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F')) bits[c] |= kHex;
+            if (alpha || digit || c == '_') bits[c] |= kWord;
+        }
+        bits[0] = 0; // strchr matches the terminator
+    }
+};
+
+static const EntityClasses kClasses;
+
+static inline bool is(char c, unsigned char cls) { return (kClasses.bits[(unsigned char)c] & cls) != 0; }
+
+static inline char lower(char c) { return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c; }
+
+static bool starts_with_nocase(const char* text, size_t length, const char* prefix) {
+    size_t n = std::strlen(prefix);
+    if (length < n) return false;
+    for (size_t i = 0; i < n; i++) {
+        if (lower(text[i]) != prefix[i]) return false;
+    }
+    return true;
+}
+
+uint32_t parse_entity_kinds(const std::vector<std::string>& names) {
+    uint32_t kinds = 0;
+    for (const std::string& name : names) {
+        if (name == "emails") kinds |= kEntityEmails;
+        else if (name == "subdomains") kinds |= kEntitySubdomains;
+        else if (name == "urls") kinds |= kEntityUrls;
+        else if (name == "ipv4") kinds |= kEntityIPv4;
+        else if (name == "ipv6") kinds |= kEntityIPv6;
+        else if (name == "all") kinds |= kEntityAll;
+        else throw std::invalid_argument("Unknown entity kind: " + name);
+    }
+    return kinds;
+}
+
+EntityExtractor::EntityExtractor(uint32_t kinds, const std::string& domain) : kinds_(kinds) {
+    size_t start = domain.find_first_not_of('.');
+    size_t end = domain.find_last_not_of('.');
+    if (start != std::string::npos) {
+        for (size_t i = start; i <= end; i++) domain_ += lower(domain[i]);
+    }
+    if (domain_.empty()) kinds_ &= ~(uint32_t)kEntitySubdomains;
+}
+
+void EntityExtractor::feed(const char* data, size_t size) {
+    size_t i = 0;
+
+    // Complete the run the previous chunk ended in
+    if (!carry_.empty()) {
+        while (i < size && is(data[i], kRun)) i++;
+        carry_.append(data, i);
+        if (i == size && carry_.size() < kMaxCarry) return;
+        scan_run(carry_.data(), carry_.size());
+        carry_.clear();
+    }
+
+    while (i < size) {
+        while (i < size && !is(data[i], kRun)) i++;
+        size_t start = i;
+        while (i < size && is(data[i], kRun)) i++;
+        if (i == start) break;
+        if (i == size && i - start < kMaxCarry) {
+            carry_.assign(data + start, i - start);
+        } else {
+            scan_run(data + start, i - start);
+        }
+    }
+}
+
+void EntityExtractor::finish() {
+    if (!carry_.empty()) scan_run(carry_.data(), carry_.size());
+    carry_.clear();
+}
+
+void EntityExtractor::scan_run(const char* run, size_t length) {
+    if (kinds_ & kEntityEmails) find_emails(run, length);
+    if (kinds_ & (kEntitySubdomains | kEntityIPv4)) find_hosts(run, length);
+    if (kinds_ & kEntityUrls) find_urls(run, length);
+    if (kinds_ & kEntityIPv6) find_ipv6(run, length);
+}
+
+void EntityExtractor::find_emails(const char* run, size_t length) {
+    // A run never splits an address: both of its character classes are inside kRun
+    EmailScanner scanner(run, length);
+    for (size_t begin, end; scanner.next(begin, end);) results_.emails.emplace_back(run + begin, end - begin);
+}
+
+// "a.b.c.d" with four octets of 1-3 digits, each <= 255
+static bool is_ipv4(const char* text, size_t length) {
+    int octets = 0;
+    size_t i = 0;
+    while (i < length) {
+        size_t start = i;
+        int value = 0;
+        while (i < length && is(text[i], kDigit) && i - start < 3) value = value * 10 + (text[i++] - '0');
+        if (i == start || value > 255) return false;
+        octets++;
+        if (i == length) break;
+        if (text[i] != '.' || octets == 4) return false;
+        i++;
+        if (i == length) return false;
+    }
+    return octets == 4;
+}
+
+// Host-name segments of the run: subdomains of the target, and IPv4 literals.
+void EntityExtractor::find_hosts(const char* run, size_t length) {
+    for (size_t i = 0; i < length;) {
+        while (i < length && !is(run[i], kHost)) i++;
+        size_t start = i;
+        while (i < length && is(run[i], kHost)) i++;
+        size_t end = i;
+
+        // Sentence punctuation and stray separators aren't part of the host
+        while (start < end && (run[start] == '.' || run[start] == '-')) start++;
+        while (end > start && (run[end - 1] == '.' || run[end - 1] == '-')) end--;
+        if (start == end) continue;
+
+        if (kinds_ & kEntitySubdomains) {
+            size_t n = domain_.size();
+            size_t host = end - start;
+            if (host > n + 1 && run[end - n - 1] == '.') {
+                bool match = true;
+                for (size_t k = 0; k < n && match; k++) match = lower(run[end - n + k]) == domain_[k];
+                if (match) results_.subdomains.emplace_back(run + start, host);
+            }
+        }
+
+        if (kinds_ & kEntityIPv4) {
+            // Maximal [0-9.] stretches that don't touch letters: "v1.2.3.4" is a version
+            for (size_t k = start; k < end;) {
+                while (k < end && !is(run[k], kDigit)) k++;
+                size_t from = k;
+                while (k < end && (is(run[k], kDigit) || run[k] == '.')) k++;
+                size_t to = k;
+                bool glued = (from > start && run[from - 1] != '.' && run[from - 1] != '-') ||
+                             (to < end && run[to] != '-');
+                while (to > from && run[to - 1] == '.') to--;
+                if (!glued && to > from && is_ipv4(run + from, to - from)) results_.ipv4.emplace_back(run + from, to - from);
+            }
+        }
+    }
+}
+
+// http:// and https:// up to the end of the run. A ',' ends the URL too:
+// lists of links are comma-joined far more often than a URL carries one.
+void EntityExtractor::find_urls(const char* run, size_t length) {
+    for (size_t i = 0; i + 8 <= length; i++) {
+        if (lower(run[i]) != 'h') continue;
+        size_t scheme;
+        if (starts_with_nocase(run + i, length - i, "http://")) scheme = 7;
+        else if (starts_with_nocase(run + i, length - i, "https://")) scheme = 8;
+        else continue;
+        if (i + scheme >= length || !is(run[i + scheme], kHost)) continue;
+
+        std::string url;
+        size_t end = length;
+        for (size_t k = i; k < end; k++) {
+            if (run[k] == ',') break;
+            if (run[k] == '&') {
+                const char* rest = run + k + 1;
+                size_t left = end - k - 1;
+                if (starts_with_nocase(rest, left, "amp;")) {
+                    url += '&';
+                    k += 4;
+                    continue;
+                }
+                // Escaped quotes and brackets close the attribute or text the URL sat in
+                if (starts_with_nocase(rest, left, "quot;") || starts_with_nocase(rest, left, "lt;") ||
+                    starts_with_nocase(rest, left, "gt;") || starts_with_nocase(rest, left, "#39;") ||
+                    starts_with_nocase(rest, left, "#x27;")) {
+                    break;
+                }
+            }
+            url += run[k];
+        }
+        while (url.size() > scheme && std::strchr(".,;:!?]", url.back())) url.pop_back();
+        if (url.size() > scheme) results_.urls.push_back(std::move(url));
+        i += scheme - 1;
+    }
+}
+
+// Full or "::" compressed; a trailing dotted quad counts as two groups
+static bool is_ipv6(const char* text, size_t length) {
+    int groups = 0;
+    int digits = 0;
+    bool compressed = false;
+    size_t i = 0;
+    if (length >= 2 && text[0] == ':' && text[1] == ':') {
+        compressed = true;
+        i = 2;
+    } else if (length > 0 && text[0] == ':') {
+        return false;
+    }
+
+    while (i < length) {
+        size_t start = i;
+        while (i < length && is(text[i], kHex)) i++;
+        if (i < length && text[i] == '.') {
+            // Embedded IPv4 must be the last thing in the literal
+            if (!is_ipv4(text + start, length - start)) return false;
+            groups += 2;
+            digits += 2;
+            i = length;
+            break;
+        }
+        size_t hex = i - start;
+        if (hex == 0 || hex > 4) return false;
+        groups++;
+        digits += (int)hex;
+        if (i == length) break;
+        i++; // ':'
+        if (i < length && text[i] == ':') {
+            if (compressed) return false;
+            compressed = true;
+            i++;
+        } else if (i == length) {
+            return false;
+        }
+    }
+    // One hex digit in all is a C++ "::f" more often than an address; the
+    // loopback is the exception worth reporting
+    if (digits < 2 && !(length == 3 && std::memcmp(text, "::1", 3) == 0)) return false;
+    if (groups > 8) return false;
+    return compressed ? groups < 8 : groups == 8;
+}
+
+void EntityExtractor::find_ipv6(const char* run, size_t length) {
+    for (size_t i = 0; i < length;) {
+        while (i < length && !(is(run[i], kHex) || run[i] == ':')) i++;
+        size_t start = i;
+        size_t colons = 0;
+        while (i < length && (is(run[i], kHex) || run[i] == ':' || run[i] == '.')) colons += run[i++] == ':';
+        size_t end = i;
+
+        // Must stand alone: "std::string" and "a::before" are words, not addresses
+        if ((start > 0 && is(run[start - 1], kWord)) || (end < length && is(run[end], kWord))) {
+            while (i < length && is(run[i], kWord)) i++;
+            continue;
+        }
+        while (end > start && run[end - 1] == '.') end--;
+        if (end > start && run[end - 1] == ':' && !(end - start >= 2 && run[end - 2] == ':')) end--;
+        if (colons >= 2 && is_ipv6(run + start, end - start)) results_.ipv6.emplace_back(run + start, end - start);
+    }
+}
+
+ExtractedEntities extract_entities(const char* data, size_t size, uint32_t kinds, const std::string& domain) {
+    EntityExtractor extractor(kinds, domain);
+    extractor.feed(data, size);
+    extractor.finish();
+    return std::move(extractor.results());
+}
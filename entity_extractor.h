@@ -0,0 +1,75 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Recognizers, combined as a bit mask.
+enum EntityKind : uint32_t {
+    kEntityEmails = 1,
+    kEntitySubdomains = 2,      // hosts under the target domain (needs a domain)
+    kEntityUrls = 4,            // http / https
+    kEntityIPv4 = 8,
+    kEntityIPv6 = 16,
+    kEntityAll = 31,
+};
+
+// "emails", "subdomains", "urls", "ipv4", "ipv6" -> mask. Throws
+// std::invalid_argument on an unknown name.
+uint32_t parse_entity_kinds(const std::vector<std::string>& names);
+
+// Every hit in text order, repeats included.
+struct ExtractedEntities {
+    std::vector<std::string> emails;
+    std::vector<std::string> subdomains;
+    std::vector<std::string> urls;
+    std::vector<std::string> ipv4;
+    std::vector<std::string> ipv6;
+};
+
+// --- Entity Extraction ---
+// The harvester used to run one regex per entity type over each whole page.
+// Here one pass over the page, through a shared 256-entry class table, cuts
+// the text into candidate runs (bytes that can appear in a URL, address or
+// host); whatever lies between runs, usually most of the page, is skipped
+// without further work. Each enabled recognizer then re-reads the run on
+// its own while it is still in cache, so a run is scanned once per
+// recognizer, not once overall:
+//   emails      the harvester's email rule (EmailScanner)
+//   subdomains  host names ending in "." + domain on a label boundary
+//   urls        from http:// or https:// to the end of the run or the
+//               first ',', minus trailing punctuation, with &amp; decoded
+//   ipv4        dotted quads with octets <= 255, not part of a longer
+//               dotted number (version strings)
+//   ipv6        full or :: compressed (optionally with a trailing quad),
+//               standing alone rather than inside a word (std::string),
+//               with at least two hex digits unless it is ::1
+// Input can arrive in chunks: a run cut off at the end of a chunk is held
+// back until the next one completes it.
+class EntityExtractor {
+public:
+    explicit EntityExtractor(uint32_t kinds, const std::string& domain = std::string());
+
+    void feed(const char* data, size_t size);
+
+    // Flushes the held-back run; call once after the last chunk.
+    void finish();
+
+    ExtractedEntities& results() { return results_; }
+
+private:
+    void scan_run(const char* run, size_t length);
+    void find_emails(const char* run, size_t length);
+    void find_hosts(const char* run, size_t length);
+    void find_urls(const char* run, size_t length);
+    void find_ipv6(const char* run, size_t length);
+
+    uint32_t kinds_;
+    std::string domain_;        // lower-cased, without a leading dot
+    std::string carry_;         // unfinished run from the previous chunk
+    ExtractedEntities results_;
+};
+
+// One-shot form for a whole buffer.
+ExtractedEntities extract_entities(const char* data, size_t size, uint32_t kinds,
+                                   const std::string& domain = std::string());
@@ -0,0 +1,184 @@
+#include "entity_set.h"
+#include <algorithm>
+#include <functional>
+
+// --- IDNA ---
+
+// Simple lower-case mapping for the scripts hosts are usually written in
+static uint32_t lower_code_point(uint32_t cp) {
+    if (cp >= 'A' && cp <= 'Z') return cp + 32;
+    if (cp >= 0xC0 && cp <= 0xDE && cp != 0xD7) return cp + 32;                  // Latin-1
+    if (cp >= 0x100 && cp <= 0x137 && cp != 0x130) return cp | 1;                // Latin Extended-A, even/odd pairs
+    if (cp >= 0x139 && cp <= 0x148) return (cp & 1) ? cp + 1 : cp;
+    if (cp >= 0x14A && cp <= 0x177) return cp | 1;
+    if (cp == 0x178) return 0xFF;
+    if (cp >= 0x179 && cp <= 0x17E) return (cp & 1) ? cp + 1 : cp;
+    if ((cp >= 0x391 && cp <= 0x3A9) && cp != 0x3A2) return cp + 32;             // Greek
+    if (cp >= 0x400 && cp <= 0x40F) return cp + 80;                              // Cyrillic
+    if (cp >= 0x410 && cp <= 0x42F) return cp + 32;
+    return cp;
+}
+
+// UTF-8 -> lower-cased code points. False on malformed input.
+static bool decode_label(const char* text, size_t length, std::vector<uint32_t>& out) {
+    const unsigned char* s = reinterpret_cast<const unsigned char*>(text);
+    for (size_t i = 0; i < length;) {
+        uint32_t cp;
+        size_t extra;
+        if (s[i] < 0x80) { cp = s[i]; extra = 0; }
+        else if ((s[i] & 0xE0) == 0xC0) { cp = s[i] & 0x1F; extra = 1; }
+        else if ((s[i] & 0xF0) == 0xE0) { cp = s[i] & 0x0F; extra = 2; }
+        else if ((s[i] & 0xF8) == 0xF0) { cp = s[i] & 0x07; extra = 3; }
+        else return false;
+        if (i + extra >= length) return false;
+        for (size_t k = 1; k <= extra; k++) {
+            if ((s[i + k] & 0xC0) != 0x80) return false;
+            cp = (cp << 6) | (s[i + k] & 0x3F);
+        }
+        static const uint32_t kMinimum[] = {0, 0x80, 0x800, 0x10000};
+        if (cp < kMinimum[extra] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return false;
+        out.push_back(lower_code_point(cp));
+        i += extra + 1;
+    }
+    return true;
+}
+
+// RFC 3492 bootstring parameters
+static const uint32_t kBase = 36, kTMin = 1, kTMax = 26, kSkew = 38, kDamp = 700;
+
+static char punycode_digit(uint32_t d) { return (char)(d < 26 ? 'a' + d : '0' + (d - 26)); }
+
+static uint32_t punycode_adapt(uint32_t delta, uint32_t points, bool first) {
+    delta = first ? delta / kDamp : delta / 2;
+    delta += delta / points;
+    uint32_t k = 0;
+    while (delta > ((kBase - kTMin) * kTMax) / 2) {
+        delta /= kBase - kTMin;
+        k += kBase;
+    }
+    return k + (kBase - kTMin + 1) * delta / (delta + kSkew);
+}
+
+static bool punycode_encode(const std::vector<uint32_t>& input, std::string& out) {
+    uint32_t n = 128, delta = 0, bias = 72;
+    uint32_t basic = 0;
+    for (uint32_t cp : input) {
+        if (cp < 0x80) {
+            out += (char)cp;
+            basic++;
+        }
+    }
+    if (basic > 0) out += '-';
+
+    uint32_t handled = basic;
+    while (handled < input.size()) {
+        uint32_t next = UINT32_MAX;
+        for (uint32_t cp : input) {
+            if (cp >= n && cp < next) next = cp;
+        }
+        if (next - n > (UINT32_MAX - delta) / (handled + 1)) return false;
+        delta += (next - n) * (handled + 1);
+        n = next;
+
+        for (uint32_t cp : input) {
+            if (cp < n && ++delta == 0) return false;
+            if (cp != n) continue;
+            uint32_t q = delta;
+            for (uint32_t k = kBase;; k += kBase) {
+                uint32_t t = k <= bias ? kTMin : k >= bias + kTMax ? kTMax : k - bias;
+                if (q < t) break;
+                out += punycode_digit(t + (q - t) % (kBase - t));
+                q = (q - t) / (kBase - t);
+            }
+            out += punycode_digit(q);
+            bias = punycode_adapt(delta, handled + 1, handled == basic);
+            delta = 0;
+            handled++;
+        }
+        delta++;
+        n++;
+    }
+    return true;
+}
+
+static void append_label(const char* label, size_t length, std::string& out) {
+    bool ascii = std::all_of(label, label + length, [](char c) { return (unsigned char)c < 0x80; });
+    std::vector<uint32_t> code_points;
+    std::string encoded;
+    if (!ascii && decode_label(label, length, code_points) && punycode_encode(code_points, encoded)) {
+        out += "xn--";
+        out += encoded;
+        return;
+    }
+    // Plain ASCII, or bytes that aren't UTF-8: lower-case what we can
+    for (size_t i = 0; i < length; i++) {
+        char c = label[i];
+        out += (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+    }
+}
+
+std::string normalize_host(const std::string& host) {
+    std::string out;
+    size_t end = host.find_last_not_of('.');
+    if (end == std::string::npos) return out;
+    end++;
+
+    for (size_t start = 0; start <= end;) {
+        size_t dot = std::min(host.find('.', start), end);
+        append_label(host.data() + start, dot - start, out);
+        if (dot < end) out += '.';
+        start = dot + 1;
+    }
+    return out;
+}
+
+std::string normalize_email(const std::string& address) {
+    size_t at = address.rfind('@');
+    if (at == std::string::npos) return normalize_host(address);
+    return address.substr(0, at + 1) + normalize_host(address.substr(at + 1));
+}
+
+// --- Entity Set ---
+
+void EntitySet::add(const std::string& value, size_t mentions) {
+    Shard& shard = shards_[std::hash<std::string>()(value) % kShards];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto inserted = shard.entries.emplace(value, Counts());
+    Counts& counts = inserted.first->second;
+    if (inserted.second) counts.first_seen = sequence_.fetch_add(1, std::memory_order_relaxed);
+    counts.sources++;
+    counts.mentions += mentions;
+}
+
+std::vector<HarvestedEntity> EntitySet::ranked() const {
+    std::vector<std::pair<uint64_t, HarvestedEntity>> all;
+    for (const Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (const auto& entry : shard.entries) {
+            HarvestedEntity entity;
+            entity.value = entry.first;
+            entity.sources = entry.second.sources;
+            entity.mentions = entry.second.mentions;
+            all.emplace_back(entry.second.first_seen, std::move(entity));
+        }
+    }
+    std::sort(all.begin(), all.end(), [](const auto& a, const auto& b) {
+        if (a.second.sources != b.second.sources) return a.second.sources > b.second.sources;
+        if (a.second.mentions != b.second.mentions) return a.second.mentions > b.second.mentions;
+        return a.first < b.first;
+    });
+
+    std::vector<HarvestedEntity> out;
+    out.reserve(all.size());
+    for (auto& entry : all) out.push_back(std::move(entry.second));
+    return out;
+}
+
+size_t EntitySet::size() const {
+    size_t total = 0;
+    for (const Shard& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total += shard.entries.size();
+    }
+    return total;
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+
+// One unique entity and how widely it was seen.
+struct HarvestedEntity {
+    std::string value;          // normalized
+    size_t sources = 0;         // pages it appeared on
+    size_t mentions = 0;        // occurrences across all of them
+};
+
+// Host names compare lower-cased, without trailing dots, with non-ASCII
+// labels in their IDNA (punycode) form: "WWW.Bücher.Example." and
+// "www.xn--bcher-kva.example" are the same host. Empty if nothing is left.
+// Case mapping of non-ASCII labels covers Latin-1, Latin Extended-A, Greek
+// and Cyrillic, not the full UTS #46 table.
+std::string normalize_host(const std::string& host);
+
+// The local part is kept as written (it is case-sensitive on paper); the
+// domain goes through normalize_host.
+std::string normalize_email(const std::string& address);
+
+// --- Entity Set ---
+// The same address turns up dozens of times across dork pages. Extraction
+// workers insert straight into this set instead of appending to one shared
+// vector: it is split into kShards independently locked hash maps picked by
+// the value's hash, so pages finishing at the same time rarely contend. Each
+// worker inserts a page's distinct values once (add one source, n mentions).
+class EntitySet {
+public:
+    void add(const std::string& value, size_t mentions = 1);
+
+    // Most sources first, then most mentions, then first seen.
+    std::vector<HarvestedEntity> ranked() const;
+
+    size_t size() const;
+
+private:
+    static const size_t kShards = 64;
+
+    struct Counts {
+        size_t sources = 0;
+        size_t mentions = 0;
+        uint64_t first_seen = 0;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<std::string, Counts> entries;
+    };
+
+    Shard shards_[kShards];
+    std::atomic<uint64_t> sequence_{0};
+};
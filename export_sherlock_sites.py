@@ -14,6 +14,10 @@ for site_name, site_info in sites_data.items():
             'url': site_info['url'],
             'errorType': site_info.get('errorType', 'status_code')
         }
+        # The C++ checker needs these to tell "no such user" apart from a profile
+        for key in ('errorMsg', 'errorCode'):
+            if key in site_info:
+                output[site_name][key] = site_info[key]
 
 with open('sherlock_sites.json', 'w') as f:
     json.dump(output, f, indent=2)
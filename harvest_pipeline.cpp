@@ -0,0 +1,135 @@
+#include "harvest_pipeline.h"
+#include "scrape_engine.h"
+#include "entity_extractor.h"
+#include <tbb/flow_graph.h>
+#include <zlib.h>
+#include <unordered_map>
+#include <algorithm>
+#include <cctype>
+#include <memory>
+
+namespace flow = tbb::flow;
+
+// Inflates a gzip / deflate body in place. A body that isn't compressed, or
+// won't inflate at all, is left as it came.
+static void decompress(ScrapeResult& page, size_t max_bytes) {
+    if (page.body.size() < 2) return;
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(page.body.data());
+
+    std::string encoding;
+    auto header = page.headers.find("content-encoding");
+    if (header != page.headers.end()) {
+        encoding = header->second;
+        std::transform(encoding.begin(), encoding.end(), encoding.begin(), ::tolower);
+    }
+
+    bool deflate = encoding.find("deflate") != std::string::npos;
+    if (!deflate && encoding.find("gzip") == std::string::npos) return;
+
+    int window_bits = 15 + 32;  // zlib or gzip wrapper, detected from the header
+    bool gzip = in[0] == 0x1f && in[1] == 0x8b;
+    bool zlib_wrapped = (in[0] & 0x0f) == 8 && ((in[0] << 8) | in[1]) % 31 == 0;
+    if (deflate && !gzip && !zlib_wrapped) window_bits = -15;  // raw deflate, as some servers send it
+
+    z_stream stream{};
+    if (inflateInit2(&stream, window_bits) != Z_OK) return;
+    stream.next_in = const_cast<Bytef*>(in);
+    stream.avail_in = (uInt)page.body.size();
+
+    BodyBuffer out;
+    out.reserve(std::min(max_bytes, page.body.size() * 4));
+    char chunk[16384];
+    int status = Z_OK;
+    while (status == Z_OK && out.size() < max_bytes) {
+        stream.next_out = reinterpret_cast<Bytef*>(chunk);
+        stream.avail_out = (uInt)std::min(sizeof(chunk), max_bytes - out.size());
+        uInt room = stream.avail_out;
+        status = inflate(&stream, Z_NO_FLUSH);
+        out.append(chunk, room - stream.avail_out);
+    }
+    inflateEnd(&stream);
+
+    // A truncated stream (the page hit its cap) still yields what inflated
+    if (out.empty() && status != Z_STREAM_END) return;
+    page.body = std::move(out);
+    page.headers.erase("content-encoding");
+}
+
+HarvesterResults harvest_pages(const std::vector<std::string>& urls, const std::string& domain,
+                               const HarvestOptions& options) {
+    HarvesterResults results;
+    if (urls.empty()) return results;
+
+    flow::graph graph;
+
+    // 1. Source: the URLs, one at a time, as the limiter lets them through
+    size_t next = 0;
+    flow::input_node<std::string> source(graph, [&](tbb::flow_control& control) -> std::string {
+        if (next == urls.size()) {
+            control.stop();
+            return std::string();
+        }
+        return urls[next++];
+    });
+    flow::limiter_node<std::string> window(graph, std::max<size_t>(1, options.max_pages_in_flight));
+
+    // 2. Fetch: hand off to the engine. The gateway's reserve/release keeps
+    //    wait_for_all() waiting while a transfer is out of the graph.
+    using FetchNode = flow::async_node<std::string, ScrapeResultPtr>;
+    FetchNode fetch(graph, flow::unlimited, [&](const std::string& url, FetchNode::gateway_type& gateway) {
+        ScrapeRequest request;
+        request.url = url;
+        request.headers.push_back("Accept-Encoding: gzip, deflate");
+        request.max_body_bytes = options.max_page_bytes;
+
+        gateway.reserve_wait();
+        ScrapeEngine::instance().submit(std::move(request), [&gateway](ScrapeResult&& response) {
+            gateway.try_put(std::make_shared<ScrapeResult>(std::move(response)));
+            gateway.release_wait();
+        });
+    });
+
+    // 3. Decompress and extract on TBB workers, while other pages are still downloading
+    flow::function_node<ScrapeResultPtr, ScrapeResultPtr> inflater(graph, flow::unlimited, [&](ScrapeResultPtr page) {
+        if (page->ok()) decompress(*page, options.max_page_bytes);
+        return page;
+    });
+    // 4. Extract + dedup: workers insert into the sharded sets directly, so
+    //    there is no serial merge stage. Each page that leaves here lets the
+    //    limiter admit the next URL.
+    std::string target = normalize_host(domain);
+    EntitySet emails;
+    EntitySet subdomains;
+    flow::function_node<ScrapeResultPtr, flow::continue_msg> extract(graph, flow::unlimited, [&](const ScrapeResultPtr& page) {
+        if (!page->ok()) return flow::continue_msg();
+        ExtractedEntities found = extract_entities(page->body.data(), page->body.size(),
+                                                   kEntityEmails | kEntitySubdomains, domain);
+
+        // One source per page: repeats within the page only add mentions
+        std::unordered_map<std::string, size_t> counts;
+        for (const std::string& email : found.emails) {
+            std::string normalized = normalize_email(email);
+            // A simple check to only get emails from the target domain
+            if (normalized.find(target) != std::string::npos) counts[std::move(normalized)]++;
+        }
+        for (auto& entry : counts) emails.add(entry.first, entry.second);
+
+        counts.clear();
+        for (const std::string& subdomain : found.subdomains) counts[normalize_host(subdomain)]++;
+        for (auto& entry : counts) subdomains.add(entry.first, entry.second);
+        return flow::continue_msg();
+    });
+
+    flow::make_edge(source, window);
+    flow::make_edge(window, fetch);
+    flow::make_edge(fetch, inflater);
+    flow::make_edge(inflater, extract);
+    flow::make_edge(extract, window.decrementer());
+
+    source.activate();
+    graph.wait_for_all();
+
+    results.emails = emails.ranked();
+    results.subdomains = subdomains.ranked();
+    return results;
+}
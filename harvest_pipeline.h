@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstddef>
+#include "entity_set.h"
+
+// What the harvester found: normalized, unique, ranked by EntitySet::ranked().
+struct HarvesterResults {
+    std::vector<HarvestedEntity> emails;
+    std::vector<HarvestedEntity> subdomains;
+};
+
+// Bounds for one harvest.
+struct HarvestOptions {
+    size_t max_pages_in_flight = 64;        // fetching, decompressing or extracting at once
+    size_t max_page_bytes = 8u << 20;       // per page, on the wire and again after inflating
+};
+
+// --- Harvest Pipeline ---
+// parallel_harvester used to wait for every page before parsing any of
+// them, so the network and the CPU never overlapped. Here every page goes
+// through a TBB flow graph as soon as it lands:
+//
+//   urls -> limiter -> fetch (async, engine) -> decompress -> extract + dedup
+//              ^                                                         |
+//              +--------------------- page done -------------------------+
+//
+//   fetch       hands the URL to the ScrapeEngine and returns at once; the
+//               engine thread puts the response back into the graph
+//   decompress  gzip / deflate bodies inflated with zlib (we ask for them:
+//               less on the wire, and the inflate runs on a TBB worker
+//               instead of the engine's loop thread)
+//   extract     EntityExtractor, emails and subdomains in one pass; each
+//               page's values are normalized and counted, then inserted
+//               straight into the shared EntitySets (see entity_set.h)
+//
+// The limiter admits a new URL only when a page has been extracted,
+// so at most max_pages_in_flight bodies are alive at any moment no matter
+// how many URLs are queued, and each is capped at max_page_bytes.
+HarvesterResults harvest_pages(const std::vector<std::string>& urls, const std::string& domain,
+                               const HarvestOptions& options = HarvestOptions());
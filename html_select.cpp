@@ -0,0 +1,371 @@
+#include "html_select.h"
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+#include <cstdlib>
+
+// A tag longer than this is treated as text rather than held back forever
+static const size_t kMaxTag = 64 * 1024;
+// Unclosed elements beyond this depth aren't tracked (broken markup)
+static const size_t kMaxDepth = 1024;
+
+static inline bool is_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f'; }
+
+static inline bool is_alpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+
+static inline char lower(char c) { return c >= 'A' && c <= 'Z' ? (char)(c - 'A' + 'a') : c; }
+
+static bool is_void(const std::string& tag) {
+    static const char* kVoid[] = {"area", "base", "br", "col", "embed", "hr", "img", "input",
+                                  "link", "meta", "param", "source", "track", "wbr"};
+    for (const char* name : kVoid) {
+        if (tag == name) return true;
+    }
+    return false;
+}
+
+// Elements whose content is text up to the matching end tag. Only these two,
+// as in html.parser (CDATA_CONTENT_ELEMENTS): markup inside <title> or
+// <textarea> is parsed like anywhere else, so BeautifulSoup finds it there.
+static bool is_raw_text(const std::string& tag) {
+    return tag == "script" || tag == "style";
+}
+
+// Case-insensitive search for a lower-case needle
+static size_t find_nocase(const char* data, size_t size, size_t from, const std::string& needle) {
+    if (needle.empty() || size < needle.size()) return std::string::npos;
+    for (size_t i = from; i + needle.size() <= size; i++) {
+        const void* hit = std::memchr(data + i, '<', size - needle.size() + 1 - i);
+        if (!hit) break;
+        i = (size_t)(static_cast<const char*>(hit) - data);
+        size_t k = 1;
+        while (k < needle.size() && lower(data[i + k]) == needle[k]) k++;
+        if (k == needle.size()) return i;
+    }
+    return std::string::npos;
+}
+
+// &amp; &lt; &gt; &quot; &apos; &#39; &nbsp; and numeric references; anything
+// else is left as written
+static std::string decode_entities(const char* data, size_t size) {
+    std::string out;
+    out.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] != '&') {
+            out += data[i];
+            continue;
+        }
+        size_t semi = i + 1;
+        while (semi < size && semi - i <= 10 && data[semi] != ';') semi++;
+        if (semi >= size || data[semi] != ';') {
+            out += '&';
+            continue;
+        }
+        std::string name(data + i + 1, semi - i - 1);
+        uint32_t cp = 0;
+        if (name == "amp") cp = '&';
+        else if (name == "lt") cp = '<';
+        else if (name == "gt") cp = '>';
+        else if (name == "quot") cp = '"';
+        else if (name == "apos") cp = '\'';
+        else if (name == "nbsp") cp = 0xA0;
+        else if (name.size() > 1 && name[0] == '#') {
+            bool hex = name[1] == 'x' || name[1] == 'X';
+            const char* digits = name.c_str() + (hex ? 2 : 1);
+            char* end = nullptr;
+            unsigned long value = std::strtoul(digits, &end, hex ? 16 : 10);
+            if (*digits && end && *end == '\0' && value > 0 && value <= 0x10FFFF) cp = (uint32_t)value;
+        }
+        if (!cp) {
+            out += '&';
+            continue;
+        }
+        // UTF-8
+        if (cp < 0x80) {
+            out += (char)cp;
+        } else if (cp < 0x800) {
+            out += (char)(0xC0 | (cp >> 6));
+            out += (char)(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += (char)(0xE0 | (cp >> 12));
+            out += (char)(0x80 | ((cp >> 6) & 0x3F));
+            out += (char)(0x80 | (cp & 0x3F));
+        } else {
+            out += (char)(0xF0 | (cp >> 18));
+            out += (char)(0x80 | ((cp >> 12) & 0x3F));
+            out += (char)(0x80 | ((cp >> 6) & 0x3F));
+            out += (char)(0x80 | (cp & 0x3F));
+        }
+        i = semi;
+    }
+    return out;
+}
+
+HtmlSelector::HtmlSelector(const std::string& selector, const std::string& attribute, bool first_per_scope,
+                           size_t max_values)
+    : first_per_scope_(first_per_scope), max_values_(max_values) {
+    for (char c : attribute) attribute_ += lower(c);
+
+    for (size_t i = 0; i < selector.size();) {
+        while (i < selector.size() && is_space(selector[i])) i++;
+        if (i == selector.size()) break;
+        size_t end = i;
+        while (end < selector.size() && !is_space(selector[end])) end++;
+
+        Compound compound;
+        size_t k = i;
+        if (selector[k] == '*') {
+            k++;
+        } else {
+            while (k < end && (std::isalnum((unsigned char)selector[k]) || selector[k] == '-')) {
+                compound.tag += lower(selector[k++]);
+            }
+        }
+        while (k < end && selector[k] == '.') {
+            size_t start = ++k;
+            while (k < end && selector[k] != '.') {
+                char c = selector[k];
+                if (!std::isalnum((unsigned char)c) && c != '-' && c != '_') break;
+                k++;
+            }
+            if (k == start) break;
+            compound.classes.emplace_back(selector, start, k - start);
+        }
+        if (k != end || (k == i)) {
+            throw std::invalid_argument("Unsupported selector: '" + selector + "' (tag, .class and descendant only)");
+        }
+        chain_.push_back(std::move(compound));
+        i = end;
+    }
+    if (chain_.empty() || chain_.size() > 32) throw std::invalid_argument("Unsupported selector: '" + selector + "'");
+}
+
+bool HtmlSelector::feed(const char* data, size_t size) {
+    if (done()) return false;
+    if (pending_.empty()) {
+        size_t used = process(data, size);
+        pending_.assign(data + used, size - used);
+    } else {
+        std::string buffer;
+        buffer.swap(pending_);
+        buffer.append(data, size);
+        size_t used = process(buffer.data(), buffer.size());
+        pending_.assign(buffer, used, std::string::npos);
+    }
+    return !done();
+}
+
+void HtmlSelector::finish() {
+    pending_.clear();
+}
+
+// Consumes what it can of `data`; the rest (an unfinished tag, or the tail
+// that might hold the start of a terminator) is left for the next chunk.
+size_t HtmlSelector::process(const char* data, size_t size) {
+    size_t i = 0;
+    while (i < size && !done()) {
+        if (mode_ == Mode::Comment) {
+            const char* hit = nullptr;
+            for (size_t k = i; k + 3 <= size; k++) {
+                const void* dash = std::memchr(data + k, '-', size - k - 2);
+                if (!dash) break;
+                k = (size_t)(static_cast<const char*>(dash) - data);
+                if (data[k + 1] == '-' && data[k + 2] == '>') {
+                    hit = data + k;
+                    break;
+                }
+            }
+            if (!hit) return std::max(i, size >= 2 ? size - 2 : 0);
+            i = (size_t)(hit - data) + 3;
+            mode_ = Mode::Text;
+            continue;
+        }
+
+        if (mode_ == Mode::RawText) {
+            size_t end = find_nocase(data, size, i, raw_end_);
+            if (end == std::string::npos) return std::max(i, size >= raw_end_.size() ? size - raw_end_.size() + 1 : 0);
+            i = end;        // the end tag itself is read as a tag below
+            mode_ = Mode::Text;
+            continue;
+        }
+
+        const void* lt = std::memchr(data + i, '<', size - i);
+        if (!lt) return size;
+        i = (size_t)(static_cast<const char*>(lt) - data);
+        if (i + 1 >= size) return i;
+
+        char next = data[i + 1];
+        if (next == '!' || next == '?') {
+            if (next == '!' && size - i < 4) return i;
+            if (next == '!' && data[i + 2] == '-' && data[i + 3] == '-') {
+                mode_ = Mode::Comment;
+                i += 4;
+                continue;
+            }
+            // <!doctype ...>, <![CDATA[ ... ]]>, <?xml ...?>: skip to the '>'
+            const void* gt = std::memchr(data + i, '>', size - i);
+            if (!gt) {
+                if (size - i > kMaxTag) {
+                    i += 2;
+                    continue;
+                }
+                return i;
+            }
+            i = (size_t)(static_cast<const char*>(gt) - data) + 1;
+            continue;
+        }
+        if (next != '/' && !is_alpha(next)) {
+            i++; // a bare '<' in text
+            continue;
+        }
+
+        // Find the closing '>', ignoring any inside quoted attribute values
+        size_t end = i + 1;
+        char quote = 0;
+        char last = 0;
+        for (; end < size; end++) {
+            char c = data[end];
+            if (quote) {
+                if (c == quote) quote = 0;
+            } else if (c == '>') {
+                break;
+            } else if ((c == '"' || c == '\'') && last == '=') {
+                quote = c;
+            }
+            if (!is_space(c)) last = c;
+        }
+        if (end >= size) {
+            if (size - i > kMaxTag) {
+                i++;
+                continue;
+            }
+            return i;
+        }
+        handle_tag(data + i + 1, end - i - 1);
+        i = end + 1;
+    }
+    return done() ? size : i;
+}
+
+static bool has_class(const std::string& classes, const std::string& name) {
+    for (size_t i = 0; i < classes.size();) {
+        while (i < classes.size() && is_space(classes[i])) i++;
+        size_t start = i;
+        while (i < classes.size() && !is_space(classes[i])) i++;
+        if (i - start == name.size() && classes.compare(start, name.size(), name) == 0) return true;
+    }
+    return false;
+}
+
+bool HtmlSelector::matches(const Compound& compound, const std::string& tag, const std::string& classes) const {
+    if (!compound.tag.empty() && compound.tag != tag) return false;
+    for (const std::string& name : compound.classes) {
+        if (!has_class(classes, name)) return false;
+    }
+    return true;
+}
+
+// `tag` is everything between '<' and '>'
+void HtmlSelector::handle_tag(const char* tag, size_t length) {
+    size_t i = 0;
+    bool closing = tag[0] == '/';
+    if (closing) i++;
+
+    std::string name;
+    while (i < length && !is_space(tag[i]) && tag[i] != '/') name += lower(tag[i++]);
+
+    if (closing) {
+        for (size_t k = stack_.size(); k-- > 0;) {
+            if (stack_[k].tag == name) {
+                stack_.resize(k);
+                break;
+            }
+        }
+        return;
+    }
+
+    // Attributes: only class and the one we were asked for are kept
+    std::string classes;
+    std::string value;
+    bool has_value = false;
+    while (i < length) {
+        while (i < length && (is_space(tag[i]) || tag[i] == '/')) i++;
+        size_t start = i;
+        while (i < length && !is_space(tag[i]) && tag[i] != '=' && tag[i] != '/') i++;
+        std::string attribute;
+        for (size_t k = start; k < i; k++) attribute += lower(tag[k]);
+        if (attribute.empty()) {
+            if (i < length) i++;
+            continue;
+        }
+
+        while (i < length && is_space(tag[i])) i++;
+        const char* text = nullptr;
+        size_t text_length = 0;
+        if (i < length && tag[i] == '=') {
+            i++;
+            while (i < length && is_space(tag[i])) i++;
+            if (i < length && (tag[i] == '"' || tag[i] == '\'')) {
+                char quote = tag[i++];
+                text = tag + i;
+                while (i < length && tag[i] != quote) i++;
+                text_length = (size_t)(tag + i - text);
+                if (i < length) i++;
+            } else {
+                text = tag + i;
+                while (i < length && !is_space(tag[i])) i++;
+                text_length = (size_t)(tag + i - text);
+            }
+        }
+
+        if (attribute == "class" && text) classes.assign(text, text_length);
+        if (attribute == attribute_ && !has_value) {
+            if (text) value = decode_entities(text, text_length);
+            has_value = true;
+        }
+    }
+    size_t last = length;
+    while (last > 0 && is_space(tag[last - 1])) last--;
+    bool self_closing = last > 0 && tag[last - 1] == '/';
+
+    // Descendant chains match greedily: prefix is how many compounds the
+    // ancestors (and this element) cover, so only the parent's count matters
+    size_t n = chain_.size();
+    size_t parent = stack_.empty() ? 0 : stack_.back().prefix;
+    bool target = parent == n - 1 && matches(chain_[n - 1], name, classes);
+    size_t prefix = parent;
+    if (prefix < n - 1 && matches(chain_[prefix], name, classes)) prefix++;
+
+    if (target) {
+        bool emit = true;
+        if (first_per_scope_ && n > 1) {
+            emit = false;
+            for (Open& open : stack_) {
+                if (open.scope && !open.satisfied) {
+                    open.satisfied = true;
+                    emit = true;
+                }
+            }
+        }
+        if (emit && !value.empty()) values_.push_back(std::move(value));
+    }
+
+    if (self_closing || is_void(name)) return;
+    if (is_raw_text(name)) {
+        mode_ = Mode::RawText;
+        raw_end_ = "</" + name;
+    }
+    if (stack_.size() < kMaxDepth) {
+        bool scope = n > 1 && matches(chain_[0], name, classes);
+        stack_.push_back({name, (uint16_t)prefix, scope, false});
+    }
+}
+
+std::vector<std::string> html_select(const char* data, size_t size, const std::string& selector,
+                                     const std::string& attribute, bool first_per_scope, size_t max_values) {
+    HtmlSelector html(selector, attribute, first_per_scope, max_values);
+    html.feed(data, size);
+    html.finish();
+    return std::move(html.values());
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// --- HTML Selector ---
+// A streaming tokenizer plus a small selector language, so link extraction
+// doesn't need the whole page in memory or a trip through BeautifulSoup.
+//
+//   selector  = compound { whitespace compound }     descendant combinator
+//   compound  = tag | "*" | [tag] "." class { "." class }
+//   e.g.        "div.g a", "a", "li.result .title a"
+//
+// Every element matching the selector contributes the value of `attribute`
+// (entity-decoded; skipped when missing or empty). With first_per_scope,
+// each element matching the first compound contributes at most once: its
+// first match, as in soup.find_all('div', class_='g') -> g.find('a').
+//
+// Input is fed in chunks as it arrives. Comments, doctypes and the bodies
+// of script / style are skipped without being tokenized (as html.parser does);
+// a tag split across chunks is held back until its '>' arrives. End tags
+// close the nearest open element of that name; void elements never open.
+class HtmlSelector {
+public:
+    // Throws std::invalid_argument for a selector outside the language above.
+    HtmlSelector(const std::string& selector, const std::string& attribute, bool first_per_scope = false,
+                 size_t max_values = 0);
+
+    // False once max_values (when > 0) have been collected: the rest of the
+    // document can be skipped.
+    bool feed(const char* data, size_t size);
+
+    // Drops whatever incomplete construct is still held back.
+    void finish();
+
+    std::vector<std::string>& values() { return values_; }
+
+private:
+    struct Compound {
+        std::string tag;                    // lower-case; empty matches any tag
+        std::vector<std::string> classes;
+    };
+
+    struct Open {
+        std::string tag;
+        uint16_t prefix;                    // compounds matched along the path, this element included
+        bool scope;                         // matches the first compound (first_per_scope)
+        bool satisfied;                     // this scope has had its match
+    };
+
+    enum class Mode { Text, Comment, RawText };
+
+    size_t process(const char* data, size_t size);
+    void handle_tag(const char* tag, size_t length);
+    bool matches(const Compound& compound, const std::string& tag, const std::string& classes) const;
+    bool done() const { return max_values_ > 0 && values_.size() >= max_values_; }
+
+    std::vector<Compound> chain_;
+    std::string attribute_;
+    bool first_per_scope_;
+    size_t max_values_;
+
+    Mode mode_ = Mode::Text;
+    std::string raw_end_;                   // "</script" etc. while in RawText
+    std::string pending_;                   // unfinished tag / terminator from the last chunk
+    std::vector<Open> stack_;
+    std::vector<std::string> values_;
+};
+
+// One-shot form for a whole buffer.
+std::vector<std::string> html_select(const char* data, size_t size, const std::string& selector,
+                                     const std::string& attribute, bool first_per_scope = false,
+                                     size_t max_values = 0);
@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+// --- Memory-mapped Files ---
+// Thin POSIX / Win32 wrapper that maps a whole file, so on-disk tables can
+// be read in place instead of parsed into heap structures at startup.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps `path` read-only. False if it can't be opened or is empty.
+    bool open_read(const std::string& path);
+
+    // Maps `path` read-write, creating it or growing it to at least `size`
+    // bytes; new bytes read as zero. Writes go straight to the file.
+    bool open_write(const std::string& path, size_t size);
+
+    void close();
+
+    char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool is_open() const { return data_ != nullptr; }
+
+private:
+    bool map(const std::string& path, size_t size, bool writable);
+
+    char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;      // HANDLEs, kept opaque so <windows.h> stays out of the header
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
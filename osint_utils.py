@@ -2,7 +2,6 @@
 
 import logging
 import requests
-from bs4 import BeautifulSoup
 from scapy.all import srp, Ether, ARP
 import subprocess
 import json
@@ -10,6 +9,7 @@ import os
 import database
 import core_utils.argus_cpp_core
 import time
+import urllib.parse
 import config
 
 # --- Tool 1: Google Dorking (NOW C++ POWERED) ---
@@ -29,32 +29,31 @@ def search_google_dorks(query: str, num_results: int = 5):
     ]
     
     # Build the URLs for the C++ scraper
-    urls_to_scrape = [f"https://www.google.com/search?q={dork}&num={num_results}" for dork in dorks]
+    urls_to_scrape = [f"https://www.google.com/search?q={urllib.parse.quote_plus(dork)}&num={num_results}"
+                      for dork in dorks]
     
     all_results = {}
     
+    # Pages arrive in completion order, so map each URL back to its dork
+    dork_for_url = {url: dorks[i] for i, url in enumerate(urls_to_scrape)}
+    
     try:
         # --- THIS IS THE C++ CALL ---
-        # It scrapes all 5 URLs at the same time
-        scraped_html_map = core_utils.argus_cpp_core.parallel_scrape(urls_to_scrape)
-        
-        # Now we parse the HTML (which is fast) in Python
-        for i, url in enumerate(urls_to_scrape):
-            html = scraped_html_map.get(url, "")
-            dork_key = dorks[i].split(" ")[0] # Get 'site:go.in' as key
+        # All 5 URLs are in flight at once, and each page is parsed in C++ as
+        # it downloads: the first <a href> of every div.g, as soup.find_all('div',
+        # class_='g') -> g.find('a') did. A page stops downloading once it has
+        # num_results links.
+        pages = core_utils.argus_cpp_core.select_stream(
+            urls_to_scrape, "div.g a", "href", first=True, max_values=num_results)
+        for url, page in pages:
+            dork_key = dork_for_url[url].split(" ")[0] # Get 'site:go.in' as key
             
-            if "CURL_ERROR" in html or not html:
+            # Failures come back as page.ok == False
+            if not page.ok:
                 all_results[dork_key] = []
                 continue
 
-            soup = BeautifulSoup(html, 'html.parser')
-            links = []
-            for g in soup.find_all('div', class_='g'): # Updated class
-                a_tag = g.find('a')
-                if a_tag and a_tag.get('href'):
-                    links.append(a_tag.get('href'))
-            
-            all_results[dork_key] = links[:num_results]
+            all_results[dork_key] = page.values[:num_results]
             
         return all_results
 
@@ -62,38 +61,29 @@ def search_google_dorks(query: str, num_results: int = 5):
         print(f"--- [OSINT-Dork-C++] Error during parallel scrape: {e} ---")
         return {"error": str(e)}
 
-def search_socials(username: str):
+def search_socials(username: str, on_batch=None):
     """
-    Uses the 'sherlock' CLI tool to find social media accounts.
+    Checks a username against every site in the Sherlock catalog using the C++ core.
+    Sites are checked concurrently with their own detection rules. Results arrive
+    in batches (everything that landed since the last one), and on_batch(batch)
+    (if given) sees each SweepBatch as soon as it is drained.
     """
     print(f"--- [OSINT-Social] Hunting for: {username} ---")
-    
-    # --- FIX: Use config.PROJECT_ROOT for a reliable path ---
-    sherlock_dir = os.path.join(config.PROJECT_ROOT, "sherlock")
-    sherlock_script = os.path.join(sherlock_dir, "sherlock", "sherlock.py")
-
-    if not os.path.exists(sherlock_script):
-        return {"error": "Sherlock not found. Path does not exist: " + sherlock_script}
 
-    command = [
-        "python3", 
-        sherlock_script, 
-        username, 
-        "--timeout", "5",
-        "--print-found"
-    ]
-    
+    profiles = []
+    unknown = []
     try:
-        result = subprocess.run(command, capture_output=True, text=True, timeout=60, check=True)
-        found_urls = result.stdout.strip().split('\n')
-        found_urls = [line.split(":")[-1].strip() for line in found_urls if "http" in line]
-        return {"username": username, "profiles": found_urls}
-    except FileNotFoundError:
-        return {"error": "Sherlock not found or 'python3' is not a valid command."}
-    except subprocess.CalledProcessError as e:
-        return {"error": f"Sherlock failed: {e.stderr}"}
+        for batch in core_utils.argus_cpp_core.sherlock_feed([username]):
+            for hit in batch.found:
+                print(f"--- [OSINT-Social] {hit.site}: {hit.url} ---")
+                profiles.append(hit.url)
+            unknown.extend(hit.site for hit in batch.unknown)
+            if on_batch:
+                on_batch(batch)
+
+        return {"username": username, "profiles": profiles, "unchecked_sites": unknown}
     except Exception as e:
-        return {"error": f"An error occurred with Sherlock: {e}"}
+        return {"error": f"An error occurred with the username sweep: {e}"}
 
 # --- Tool 3: Domain Intel (theHarvester) ---
 def find_domain_intel(domain: str):
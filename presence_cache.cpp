@@ -0,0 +1,151 @@
+#define NOMINMAX
+#include "presence_cache.h"
+#include "cache_dir.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+static const char kMagic[4] = {'A', 'G', 'P', '1'};
+static const char* kTableName = "presence_cache.bin";
+
+static long long unix_now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Same two FNV-1a passes as the response cache, over "site\0username".
+// key_a is forced non-zero since zero marks an empty slot.
+static void presence_key(std::string_view site, const std::string& username, uint64_t& key_a, uint64_t& key_b) {
+    uint64_t a = 1469598103934665603ULL;
+    uint64_t b = 0x84222325cbf29ce4ULL;
+    auto mix = [&](unsigned char c) {
+        a = (a ^ c) * 1099511628211ULL;
+        b = (b ^ c) * 0x100000001b3ULL;
+        b ^= b >> 29;
+    };
+    for (unsigned char c : site) mix(c);
+    mix(0);
+    for (unsigned char c : username) mix(c);
+    key_a = a ? a : 1;
+    key_b = b;
+}
+
+PresenceCache& PresenceCache::instance() {
+    static PresenceCache* cache = new PresenceCache();
+    return *cache;
+}
+
+PresenceCache::PresenceCache() {
+    size_t size = sizeof(Header) + (size_t)kSlots * sizeof(Slot);
+    std::string path = cache_path(kTableName);
+    // Unwritable directory: run without a cache rather than fail the sweep
+    if (!file_.open_write(path, size)) return;
+
+    Header* header = reinterpret_cast<Header*>(file_.data());
+    if (file_.size() != size || std::memcmp(header->magic, kMagic, 4) != 0 || header->slot_count != kSlots) {
+        // New file, or one from a different layout: start empty
+        if (file_.size() != size) {
+            file_.close();
+            std::remove(path.c_str());
+            if (!file_.open_write(path, size)) return;
+            header = reinterpret_cast<Header*>(file_.data());
+        }
+        std::memset(file_.data(), 0, size);
+        std::memcpy(header->magic, kMagic, 4);
+        header->slot_count = kSlots;
+    }
+}
+
+// The slot holding the key, else the slot a store should take: the first
+// empty one in the window, or failing that the oldest.
+PresenceCache::Slot* PresenceCache::find_locked(uint64_t key_a, uint64_t key_b) {
+    Slot* table = slots();
+    Slot* victim = nullptr;
+    for (uint32_t i = 0; i < kProbeWindow; i++) {
+        Slot* slot = &table[(key_a + i) & (kSlots - 1)];
+        if (slot->key_a == key_a && slot->key_b == key_b) return slot;
+        if (slot->key_a == 0) {
+            if (!victim || victim->key_a != 0) victim = slot;
+        } else if (!victim || (victim->key_a != 0 && slot->checked_at < victim->checked_at)) {
+            victim = slot;
+        }
+    }
+    return victim;
+}
+
+double PresenceCache::ttl_locked(SiteStatus status) const {
+    switch (status) {
+    case SiteStatus::Found:
+        return options_.found_ttl_seconds;
+    case SiteStatus::NotFound:
+        return options_.not_found_ttl_seconds;
+    default:
+        return options_.error_ttl_seconds;
+    }
+}
+
+bool PresenceCache::lookup(std::string_view site, const std::string& username, SiteCheck& check) {
+    uint64_t key_a, key_b;
+    presence_key(site, username, key_a, key_b);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open()) return false;
+
+    Slot* slot = find_locked(key_a, key_b);
+    if (slot && slot->key_a == key_a && slot->key_b == key_b) {
+        SiteStatus status = (SiteStatus)slot->status;
+        double ttl = ttl_locked(status);
+        if (ttl > 0 && unix_now() - slot->checked_at < ttl) {
+            check.status = status;
+            check.http_status = slot->http_status;
+            check.elapsed = 0;
+            check.cached = true;
+            hits_++;
+            return true;
+        }
+    }
+    misses_++;
+    return false;
+}
+
+void PresenceCache::store(std::string_view site, const std::string& username, const SiteCheck& check) {
+    uint64_t key_a, key_b;
+    presence_key(site, username, key_a, key_b);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open()) return;
+
+    Slot* slot = find_locked(key_a, key_b);
+    slot->key_b = key_b;
+    slot->checked_at = unix_now();
+    slot->http_status = (uint16_t)check.http_status;
+    slot->status = (uint8_t)check.status;
+    slot->key_a = key_a;
+    stores_++;
+}
+
+void PresenceCache::configure(const PresenceOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    options_ = options;
+}
+
+PresenceOptions PresenceCache::options() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return options_;
+}
+
+void PresenceCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open()) return;
+    std::memset(slots(), 0, (size_t)kSlots * sizeof(Slot));
+}
+
+std::map<std::string, unsigned long long> PresenceCache::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    unsigned long long entries = 0;
+    if (file_.is_open()) {
+        const Slot* table = slots();
+        for (uint32_t i = 0; i < kSlots; i++) entries += table[i].key_a != 0;
+    }
+    return {{"hits", hits_}, {"misses", misses_}, {"stores", stores_}, {"entries", entries}, {"capacity", kSlots}};
+}
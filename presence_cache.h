@@ -0,0 +1,80 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <map>
+#include <mutex>
+#include <cstdint>
+#include "mapped_file.h"
+#include "sherlock_check.h"
+
+// How long each kind of verdict stays good. A TTL of 0 means that verdict
+// is never answered from the cache.
+struct PresenceOptions {
+    double found_ttl_seconds = 7 * 24 * 3600.0;     // profiles rarely vanish
+    double not_found_ttl_seconds = 24 * 3600.0;     // a name can be registered any day
+    double error_ttl_seconds = 0;                   // errors are usually transient
+};
+
+// --- Username Presence Cache ---
+// Dossiers re-run the same usernames within hours. PresenceCache remembers
+// each (site, username) verdict with the time it was decided, so check_site
+// answers from it while the verdict is fresh and only goes to the network
+// once it has expired.
+//
+// The table lives in presence_cache.bin under the user's cache directory
+// ($ARGUS_CACHE_DIR overrides it) and is memory-mapped: no load step
+// at startup and no save step afterwards. It is a fixed array of kSlots
+// 32-byte slots keyed by a 128-bit hash of the pair, open-addressed over a
+// kProbeWindow window; when the window is full the oldest slot in it is
+// overwritten, so the file never grows.
+class PresenceCache {
+public:
+    static PresenceCache& instance();
+
+    // Fills status / http_status and sets `cached` if a fresh verdict exists.
+    bool lookup(std::string_view site, const std::string& username, SiteCheck& check);
+    void store(std::string_view site, const std::string& username, const SiteCheck& check);
+
+    void configure(const PresenceOptions& options);
+    PresenceOptions options();
+    void clear();
+
+    // hits, misses, stores, entries, capacity
+    std::map<std::string, unsigned long long> stats();
+
+    PresenceCache(const PresenceCache&) = delete;
+    PresenceCache& operator=(const PresenceCache&) = delete;
+
+private:
+    static const uint32_t kSlots = 1 << 16;
+    static const uint32_t kProbeWindow = 16;
+
+    struct Slot {
+        uint64_t key_a;             // 0 marks an empty slot
+        uint64_t key_b;
+        int64_t checked_at;         // unix seconds
+        uint16_t http_status;
+        uint8_t status;             // SiteStatus
+        uint8_t reserved[5];
+    };
+    static_assert(sizeof(Slot) == 32, "slot layout is part of the file format");
+
+    struct Header {
+        char magic[4];
+        uint32_t slot_count;
+        uint64_t reserved;
+    };
+
+    PresenceCache();
+
+    Slot* slots() { return reinterpret_cast<Slot*>(file_.data() + sizeof(Header)); }
+    Slot* find_locked(uint64_t key_a, uint64_t key_b);
+    double ttl_locked(SiteStatus status) const;
+
+    std::mutex mutex_;
+    MappedFile file_;
+    PresenceOptions options_;
+    unsigned long long hits_ = 0;
+    unsigned long long misses_ = 0;
+    unsigned long long stores_ = 0;
+};
@@ -888,6 +888,11 @@ window.handleBackendMessage = function(data) {
             showToast(`Tool '${data.data.name}' forged successfully!`, 'success');
             break;
             
+        case 'dossier_progress':
+            // Live hits from a running username sweep
+            showDossierProgress(data.data);
+            break;
+            
         case 'dossier_complete':
             // Dossier compilation done
             showDossierReport(data.data);
@@ -1065,6 +1070,38 @@ function showDossierReport(data) {
     addChatMessage('system', `Dossier for "${data.query}" compiled with ${Object.keys(data.intel).length} intelligence packets.`);
 }
 
+function showDossierProgress(data) {
+    let live = document.getElementById('dossier-live');
+    if (!live || live.dataset.query !== data.query) {
+        showPanel('workspace-panel');
+        const workspace = document.getElementById('workspace-content');
+        workspace.innerHTML = `
+            <div style="padding: 20px; width: 100%; height: 100%; overflow-y: auto;">
+                <h2 style="color: var(--gold-primary); font-family: 'Orbitron', sans-serif; margin-bottom: 20px;">
+                    DOSSIER: ${data.query}
+                </h2>
+                <div id="dossier-live">
+                    <div id="dossier-live-progress" style="margin-bottom: 10px; font-size: 12px;"></div>
+                    <div id="dossier-live-found"></div>
+                </div>
+            </div>
+        `;
+        live = document.getElementById('dossier-live');
+        live.dataset.query = data.query;
+    }
+    
+    document.getElementById('dossier-live-progress').textContent =
+        `${data.tool}: ${data.done} / ${data.total} sites checked`;
+    
+    const found = document.getElementById('dossier-live-found');
+    data.found.forEach(hit => {
+        const row = document.createElement('div');
+        row.style.cssText = 'border-left: 3px solid var(--gold-primary); padding: 4px 10px; margin-bottom: 4px;';
+        row.textContent = `${hit.site}: ${hit.url}`;
+        found.appendChild(row);
+    });
+}
+
 function createWebview(data) {
     showPanel('workspace-panel');
     document.getElementById('workspace-title').innerHTML = `<span class="panel-icon">🌐</span>${data.title}`;
@@ -0,0 +1,377 @@
+#define NOMINMAX
+#include "response_cache.h"
+#include "cache_dir.h"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <zlib.h>
+
+namespace fs = std::filesystem;
+
+static const char kMagic[4] = {'A', 'G', 'C', '1'};
+
+static long long unix_now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+static std::string lower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return text;
+}
+
+std::string normalize_url(const std::string& url) {
+    CURLU* parsed = curl_url();
+    if (curl_url_set(parsed, CURLUPART_URL, url.c_str(), CURLU_DEFAULT_SCHEME) != CURLUE_OK) {
+        curl_url_cleanup(parsed);
+        return url;
+    }
+
+    auto part = [&](CURLUPart which, unsigned int flags = 0) {
+        char* value = nullptr;
+        std::string out;
+        if (curl_url_get(parsed, which, &value, flags) == CURLUE_OK && value) {
+            out = value;
+            curl_free(value);
+        }
+        return out;
+    };
+
+    std::string scheme = lower(part(CURLUPART_SCHEME));
+    std::string host = lower(part(CURLUPART_HOST));
+    std::string port = part(CURLUPART_PORT, CURLU_NO_DEFAULT_PORT);
+    std::string path = part(CURLUPART_PATH);
+    std::string query = part(CURLUPART_QUERY);
+    curl_url_cleanup(parsed);
+
+    std::string normalized = scheme + "://" + host;
+    if (!port.empty()) normalized += ":" + port;
+    normalized += path.empty() ? "/" : path;
+    if (!query.empty()) normalized += "?" + query;
+    return normalized;
+}
+
+// 128 bits from two FNV-1a passes with different offsets; plenty to keep
+// URLs apart in a cache directory.
+static std::string hash_hex(const std::string& text) {
+    uint64_t a = 1469598103934665603ULL;
+    uint64_t b = 0x84222325cbf29ce4ULL;
+    for (unsigned char c : text) {
+        a = (a ^ c) * 1099511628211ULL;
+        b = (b ^ c) * 0x100000001b3ULL;
+        b ^= b >> 29;
+    }
+
+    static const char* digits = "0123456789abcdef";
+    std::string out(32, '0');
+    for (int i = 0; i < 16; i++) {
+        out[15 - i] = digits[(a >> (i * 4)) & 0xf];
+        out[31 - i] = digits[(b >> (i * 4)) & 0xf];
+    }
+    return out;
+}
+
+// --- File format helpers ---
+static void put_u32(std::string& out, uint32_t value) { out.append((const char*)&value, sizeof(value)); }
+static void put_i64(std::string& out, int64_t value) { out.append((const char*)&value, sizeof(value)); }
+static void put_str(std::string& out, const std::string& value) {
+    put_u32(out, (uint32_t)value.size());
+    out.append(value);
+}
+
+struct Reader {
+    const std::string& data;
+    size_t at = 0;
+
+    template <typename T>
+    bool get(T& value) {
+        if (at + sizeof(T) > data.size()) return false;
+        std::memcpy(&value, data.data() + at, sizeof(T));
+        at += sizeof(T);
+        return true;
+    }
+    bool get_str(std::string& value) {
+        uint32_t length;
+        if (!get(length) || at + length > data.size()) return false;
+        value.assign(data, at, length);
+        at += length;
+        return true;
+    }
+};
+
+ResponseCache& ResponseCache::instance() {
+    static ResponseCache* cache = new ResponseCache();
+    return *cache;
+}
+
+ResponseCache::ResponseCache() {
+    writer_ = std::thread(&ResponseCache::write_loop, this);
+    writer_.detach();
+}
+
+void ResponseCache::post(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(jobs_mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    jobs_cv_.notify_one();
+}
+
+void ResponseCache::write_loop() {
+    for (;;) {
+        std::deque<std::function<void()>> batch;
+        {
+            std::unique_lock<std::mutex> lock(jobs_mutex_);
+            jobs_cv_.wait(lock, [this] { return !jobs_.empty(); });
+            batch.swap(jobs_);
+        }
+        for (auto& job : batch) job();
+    }
+}
+
+std::string ResponseCache::path_for(const CacheOptions& options, const std::string& url) {
+    std::string key = hash_hex(normalize_url(url));
+    return (fs::path(options.directory) / key.substr(0, 2) / (key + ".bin")).string();
+}
+
+bool ResponseCache::load(const std::string& path, Entry& entry) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    Reader reader{data};
+    int64_t stored_at;
+    int32_t status;
+    uint32_t raw_size;
+    if (data.size() < sizeof(kMagic) || std::memcmp(data.data(), kMagic, sizeof(kMagic)) != 0) return false;
+    reader.at = sizeof(kMagic);
+
+    if (!reader.get(stored_at) || !reader.get(status) || !reader.get(raw_size) ||
+        !reader.get_str(entry.final_url) || !reader.get_str(entry.content_type) ||
+        !reader.get_str(entry.etag) || !reader.get_str(entry.last_modified) ||
+        !reader.get_str(entry.compressed)) {
+        return false;
+    }
+    entry.stored_at = stored_at;
+    entry.status = status;
+    entry.raw_size = raw_size;
+    return true;
+}
+
+// The on-disk form of `result`; empty if compression fails.
+std::string ResponseCache::encode(const ScrapeResult& result) {
+    uLongf compressed_size = compressBound((uLong)result.body.size());
+    std::string compressed(compressed_size, '\0');
+    if (compress2((Bytef*)&compressed[0], &compressed_size, (const Bytef*)result.body.data(),
+                  (uLong)result.body.size(), Z_BEST_SPEED) != Z_OK) {
+        return std::string();
+    }
+    compressed.resize(compressed_size);
+
+    auto header = [&](const char* name) {
+        auto it = result.headers.find(name);
+        return it == result.headers.end() ? std::string() : it->second;
+    };
+
+    std::string data(kMagic, sizeof(kMagic));
+    put_i64(data, unix_now());
+    put_u32(data, (uint32_t)result.status);
+    put_u32(data, (uint32_t)result.body.size());
+    put_str(data, result.final_url);
+    put_str(data, header("content-type"));
+    put_str(data, header("etag"));
+    put_str(data, header("last-modified"));
+    put_str(data, compressed);
+    return data;
+}
+
+void ResponseCache::store(const CacheOptions& options, const std::string& path, const std::string& data) {
+    // Write beside the target and rename, so readers never see half a file
+    std::error_code ec;
+    fs::create_directories(fs::path(path).parent_path(), ec);
+    std::string temp = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file) return;
+        file.write(data.data(), (std::streamsize)data.size());
+        if (!file) return;
+    }
+
+    // Seed the directory's index before the new file lands, so the
+    // first scan doesn't count it twice
+    Directory& dir = directory(options);
+    fs::rename(temp, path, ec);
+    if (ec) {
+        fs::remove(temp, ec);
+        return;
+    }
+
+    stores_++;
+    track(dir, path, (long long)data.size());
+    enforce_budget(options, dir);
+}
+
+void ResponseCache::touch(const CacheOptions& options, const std::string& path) {
+    std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!file) return;
+    int64_t now = unix_now();
+    file.seekp(sizeof(kMagic));
+    file.write((const char*)&now, sizeof(now));
+    file.close();
+
+    // A revalidated entry counts as new again for eviction
+    Directory& dir = directory(options);
+    auto known = dir.files.find(path);
+    if (known != dir.files.end()) track(dir, path, known->second.second);
+}
+
+void ResponseCache::fill_from_entry(const Entry& entry, ScrapeResult& result) {
+    result.status = entry.status;
+    result.final_url = entry.final_url;
+    if (!entry.content_type.empty()) result.headers["content-type"] = entry.content_type;
+    if (!entry.etag.empty()) result.headers["etag"] = entry.etag;
+    if (!entry.last_modified.empty()) result.headers["last-modified"] = entry.last_modified;
+
+    uLongf raw_size = (uLongf)entry.raw_size;
+    char* out = result.body.grow(entry.raw_size);
+    if (uncompress((Bytef*)out, &raw_size, (const Bytef*)entry.compressed.data(),
+                   (uLong)entry.compressed.size()) != Z_OK) {
+        result.curl_code = CURLE_READ_ERROR;
+        result.error = "cache entry is corrupt";
+    }
+    result.bytes = result.body.size();
+}
+
+// The index for a cache directory, built from one scan (oldest write
+// first) the first time the writer sees it.
+ResponseCache::Directory& ResponseCache::directory(const CacheOptions& options) {
+    auto [found, inserted] = directories_.try_emplace(options.directory);
+    Directory& dir = found->second;
+    if (!inserted) return dir;
+
+    struct File {
+        std::string path;
+        fs::file_time_type written;
+        long long size;
+    };
+    std::vector<File> files;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(options.directory, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        files.push_back({it->path().string(), it->last_write_time(ec), (long long)it->file_size(ec)});
+    }
+    std::sort(files.begin(), files.end(), [](const File& a, const File& b) { return a.written < b.written; });
+    for (const File& file : files) track(dir, file.path, file.size);
+    return dir;
+}
+
+// Records `path` as the newest entry of `dir`, replacing what was known about it
+void ResponseCache::track(Directory& dir, const std::string& path, long long size) {
+    auto [known, inserted] = dir.files.try_emplace(path, 0, 0);
+    if (!inserted) {
+        dir.bytes -= known->second.second;
+        dir.oldest.erase({known->second.first, path});
+    }
+    known->second = {dir.next_age++, size};
+    dir.bytes += size;
+    dir.oldest.emplace(known->second.first, path);
+}
+
+// Keeps a cache directory under its byte budget by deleting the oldest
+// entries; eviction trims to 90% so a full cache doesn't evict on every store.
+void ResponseCache::enforce_budget(const CacheOptions& options, Directory& dir) {
+    if (dir.bytes <= (long long)options.max_bytes) return;
+
+    long long target = (long long)(options.max_bytes * 0.9);
+    std::error_code ec;
+    while (dir.bytes > target && !dir.oldest.empty()) {
+        std::string path = dir.oldest.begin()->second;
+        dir.oldest.erase(dir.oldest.begin());
+        auto known = dir.files.find(path);
+        dir.bytes -= known->second.second;
+        dir.files.erase(known);
+        if (fs::remove(path, ec)) evictions_++;
+    }
+}
+
+void ResponseCache::submit(ScrapeRequest request, const CacheOptions& requested, ScrapeEngine::Completion done) {
+    ScrapeEngine& engine = ScrapeEngine::instance();
+    if (requested.ttl_seconds <= 0 || request.head_only) {
+        engine.submit(std::move(request), std::move(done));
+        return;
+    }
+
+    CacheOptions options = requested;
+    if (options.directory.empty()) {
+        static const std::string default_directory = cache_path("scrape_cache");
+        options.directory = default_directory;
+    }
+
+    std::string path = path_for(options, request.url);
+    auto entry = std::make_shared<Entry>();
+    bool cached = load(path, *entry);
+
+    // 1. Fresh hit: answer right here, no network
+    if (cached && unix_now() - entry->stored_at < options.ttl_seconds) {
+        hits_++;
+        ScrapeResult result;
+        result.url = request.url;
+        result.cache_status = "hit";
+        fill_from_entry(*entry, result);
+        done(std::move(result));
+        return;
+    }
+
+    // 2. Stale but revalidatable: ask the server whether it changed
+    bool revalidating = cached && (!entry->etag.empty() || !entry->last_modified.empty());
+    if (revalidating) {
+        if (!entry->etag.empty()) request.headers.push_back("If-None-Match: " + entry->etag);
+        if (!entry->last_modified.empty()) request.headers.push_back("If-Modified-Since: " + entry->last_modified);
+    }
+
+    // 3. Fetch; keep what comes back. This runs on the engine's loop thread,
+    //    so anything touching zlib or the disk moves the result to the
+    //    writer, which finishes it and hands it on.
+    engine.submit(std::move(request), [this, options, path, entry, revalidating, done = std::move(done)](ScrapeResult&& response) {
+        auto result = std::make_shared<ScrapeResult>(std::move(response));
+        if (revalidating && result->ok() && result->status == 304) {
+            revalidated_++;
+            result->cache_status = "revalidated";
+            post([this, options, path, entry, result, done] {
+                fill_from_entry(*entry, *result);
+                done(std::move(*result));
+                touch(options, path);
+            });
+            return;
+        }
+
+        misses_++;
+        result->cache_status = "miss";
+        if (!result->ok() || result->status != 200 || result->body.empty()) {
+            done(std::move(*result));
+            return;
+        }
+        // Encode before the caller takes the body, write after it has it
+        post([this, options, path, result, done] {
+            std::string data = encode(*result);
+            done(std::move(*result));
+            if (!data.empty()) store(options, path, data);
+        });
+    });
+}
+
+std::map<std::string, unsigned long long> ResponseCache::stats() {
+    std::map<std::string, unsigned long long> out;
+    out["hits"] = hits_;
+    out["misses"] = misses_;
+    out["revalidated"] = revalidated_;
+    out["stores"] = stores_;
+    out["evictions"] = evictions_;
+    return out;
+}
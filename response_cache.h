@@ -0,0 +1,105 @@
+#pragma once
+#include <string>
+#include <map>
+#include <set>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <condition_variable>
+#include "scrape_engine.h"
+
+// Per-call cache settings. ttl_seconds <= 0 turns the cache off for the call.
+// An empty directory means scrape_cache under the user's cache directory
+// (cache_dir.h), wherever the process was started from.
+struct CacheOptions {
+    double ttl_seconds = 0;
+    unsigned long long max_bytes = 256ull << 20;   // on-disk budget for `directory`
+    std::string directory;
+};
+
+// --- The Response Cache ---
+// Content-addressed on-disk store for page bodies, so re-running a dossier
+// on the same target doesn't re-download identical pages.
+//   * key: hash of the normalized URL (lower-case scheme/host, default port
+//     and fragment dropped), stored as <directory>/<2 hex>/<32 hex>.bin
+//   * value: zlib-compressed body plus status, final URL, content type,
+//     ETag and Last-Modified
+//   * fresh entries (younger than ttl_seconds) are answered without touching
+//     the network; stale ones with validators go out with If-None-Match /
+//     If-Modified-Since and a 304 serves the stored body
+//   * when a directory grows past max_bytes the oldest entries are evicted
+//
+// Compressing, decompressing, writing, touching and evicting all happen on
+// the cache's own writer thread, never on the engine's loop thread: a
+// completion that has disk or zlib work hands the result over and the
+// writer finishes it. Each directory is scanned once, the first time it is
+// written to; after that its size and age order are kept in memory.
+class ResponseCache {
+public:
+    static ResponseCache& instance();
+
+    // Routes `request` through the cache. `done` runs on the calling thread
+    // for a fresh hit, on the writer thread for a stored or revalidated
+    // response, and on the engine thread for anything else.
+    void submit(ScrapeRequest request, const CacheOptions& options, ScrapeEngine::Completion done);
+
+    std::map<std::string, unsigned long long> stats();
+
+    ResponseCache(const ResponseCache&) = delete;
+    ResponseCache& operator=(const ResponseCache&) = delete;
+
+private:
+    struct Entry {
+        long long stored_at = 0;    // unix seconds
+        long status = 0;
+        std::string final_url;
+        std::string content_type;
+        std::string etag;
+        std::string last_modified;
+        std::string compressed;
+        size_t raw_size = 0;
+    };
+
+    // What the writer thread knows about one cache directory
+    struct Directory {
+        long long bytes = 0;
+        uint64_t next_age = 0;
+        std::map<std::string, std::pair<uint64_t, long long>> files;   // path -> (age, size)
+        std::set<std::pair<uint64_t, std::string>> oldest;             // (age, path), oldest first
+    };
+
+    ResponseCache();
+
+    std::string path_for(const CacheOptions& options, const std::string& url);
+    bool load(const std::string& path, Entry& entry);
+    void fill_from_entry(const Entry& entry, ScrapeResult& result);
+
+    // Queued from any thread; run in order on the writer thread
+    void post(std::function<void()> job);
+    void write_loop();
+
+    // Writer thread only
+    std::string encode(const ScrapeResult& result);
+    void store(const CacheOptions& options, const std::string& path, const std::string& data);
+    void touch(const CacheOptions& options, const std::string& path);
+    Directory& directory(const CacheOptions& options);
+    void track(Directory& dir, const std::string& path, long long size);
+    void enforce_budget(const CacheOptions& options, Directory& dir);
+
+    std::mutex jobs_mutex_;
+    std::condition_variable jobs_cv_;
+    std::deque<std::function<void()>> jobs_;
+    std::thread writer_;
+    std::map<std::string, Directory> directories_;     // writer thread only
+
+    std::atomic<unsigned long long> hits_{0};
+    std::atomic<unsigned long long> misses_{0};
+    std::atomic<unsigned long long> revalidated_{0};
+    std::atomic<unsigned long long> stores_{0};
+    std::atomic<unsigned long long> evictions_{0};
+};
+
+// Lower-cases scheme and host, drops the default port and the fragment.
+std::string normalize_url(const std::string& url);
@@ -0,0 +1,603 @@
+#define NOMINMAX
+#include "scrape_engine.h"
+#include "connection_pool.h"
+#include "response_cache.h"
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+#include <cctype>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+// Everything the loop thread needs to know about one transfer.
+// Stored in CURLOPT_PRIVATE so completions can find their way back.
+struct ScrapeEngine::Transfer {
+    ScrapeRequest request;
+    std::string host;
+    Completion done;
+    CURL* easy = nullptr;
+    curl_slist* headers = nullptr;
+    ScrapeResult response;
+    size_t streamed = 0;        // body bytes handed to request.on_body so far
+};
+
+// Pre-sizing from Content-Length stops here; a bigger body grows as it
+// arrives, so a lying or huge header can't make us allocate it up front.
+static const size_t kMaxBodyReserve = 8u << 20;
+
+// Size the body buffer once, at the first chunk, instead of growing it chunk
+// by chunk. `cap` is the most the caller will keep (0 = no cap of its own).
+static void reserve_body(ScrapeResult& result, size_t cap) {
+    if (!result.body.empty()) return;
+    auto length = result.headers.find("content-length");
+    if (length == result.headers.end()) return;
+    size_t wanted = (size_t)std::strtoull(length->second.c_str(), nullptr, 10);
+    if (cap > 0) wanted = std::min(wanted, cap);
+    result.body.reserve(std::min(wanted, kMaxBodyReserve));
+}
+
+static size_t EngineWriteCallback(void* contents, size_t size, size_t nmemb, ScrapeResult* result) {
+    reserve_body(*result, 0);
+    result->body.append((char*)contents, size * nmemb);
+    return size * nmemb;
+}
+
+// Only these make it into ScrapeResult::headers; the rest is noise for OSINT.
+static const char* kKeptHeaders[] = {
+    "content-type", "content-length", "content-encoding", "location", "server",
+    "etag", "last-modified", "cache-control", "retry-after", "x-ratelimit-remaining",
+};
+
+static size_t EngineHeaderCallback(char* buffer, size_t size, size_t nitems, ScrapeResult* result) {
+    size_t length = size * nitems;
+    std::string line(buffer, length);
+
+    // A new status line means a redirect hop: forget the previous response's headers
+    if (line.compare(0, 5, "HTTP/") == 0) {
+        result->headers.clear();
+        return length;
+    }
+
+    size_t colon = line.find(':');
+    if (colon == std::string::npos) return length;
+
+    std::string name = line.substr(0, colon);
+    std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+
+    for (const char* kept : kKeptHeaders) {
+        if (name != kept) continue;
+        size_t begin = line.find_first_not_of(" \t", colon + 1);
+        size_t end = line.find_last_not_of(" \t\r\n");
+        std::string value = (begin == std::string::npos || end < begin) ? "" : line.substr(begin, end - begin + 1);
+        result->headers[name] = std::move(value);
+        break;
+    }
+    return length;
+}
+
+void capture_result(CURL* curl, ScrapeResult& result) {
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, EngineWriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &result);
+    curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, EngineHeaderCallback);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &result);
+}
+
+void finish_result(CURL* curl, CURLcode code, ScrapeResult& result) {
+    result.curl_code = code;
+    if (code != CURLE_OK) result.error = curl_easy_strerror(code);
+
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &result.status);
+
+    char* effective = nullptr;
+    curl_easy_getinfo(curl, CURLINFO_EFFECTIVE_URL, &effective);
+    result.final_url = effective ? effective : result.url;
+
+    curl_off_t downloaded = 0;
+    curl_easy_getinfo(curl, CURLINFO_SIZE_DOWNLOAD_T, &downloaded);
+    result.bytes = (size_t)downloaded;
+
+    curl_off_t us = 0;
+    curl_easy_getinfo(curl, CURLINFO_NAMELOOKUP_TIME_T, &us);
+    result.timings.dns = us / 1e6;
+    curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME_T, &us);
+    result.timings.connect = us / 1e6;
+    curl_easy_getinfo(curl, CURLINFO_APPCONNECT_TIME_T, &us);
+    result.timings.tls = us / 1e6;
+    curl_easy_getinfo(curl, CURLINFO_STARTTRANSFER_TIME_T, &us);
+    result.timings.ttfb = us / 1e6;
+    curl_easy_getinfo(curl, CURLINFO_TOTAL_TIME_T, &us);
+    result.timings.total = us / 1e6;
+}
+
+// Lower-cased host part of a URL, the scheduler's bucket key.
+static std::string host_of(const std::string& url) {
+    std::string host;
+    CURLU* parsed = curl_url();
+    char* part = nullptr;
+    if (curl_url_set(parsed, CURLUPART_URL, url.c_str(), CURLU_DEFAULT_SCHEME) == CURLUE_OK &&
+        curl_url_get(parsed, CURLUPART_HOST, &part, 0) == CURLUE_OK) {
+        host = part;
+        curl_free(part);
+    }
+    curl_url_cleanup(parsed);
+
+    std::transform(host.begin(), host.end(), host.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return host;
+}
+
+static std::string lower(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return text;
+}
+
+ScrapeEngine& ScrapeEngine::instance() {
+    static ScrapeEngine* engine = new ScrapeEngine();
+    return *engine;
+}
+
+ScrapeEngine::ScrapeEngine() {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    multi_ = curl_multi_init();
+
+#ifdef __linux__
+    // 1. epoll watches every socket curl hands us, plus an eventfd that
+    //    submit() pokes when new work arrives.
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = wake_fd_;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+
+    // 2. curl tells us which sockets to watch and when its next timeout is.
+    curl_multi_setopt(multi_, CURLMOPT_SOCKETFUNCTION, &ScrapeEngine::on_socket);
+    curl_multi_setopt(multi_, CURLMOPT_SOCKETDATA, this);
+    curl_multi_setopt(multi_, CURLMOPT_TIMERFUNCTION, &ScrapeEngine::on_timer);
+    curl_multi_setopt(multi_, CURLMOPT_TIMERDATA, this);
+#endif
+
+    loop_ = std::thread(&ScrapeEngine::run, this);
+    loop_.detach();
+}
+
+EngineConfig ScrapeEngine::config() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return config_;
+}
+
+void ScrapeEngine::configure(const EngineConfig& config) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_ = config;
+        config_.max_in_flight = std::max(1L, config_.max_in_flight);
+        config_.max_host_connections = std::max(0L, config_.max_host_connections);
+        config_.max_streams_per_connection = std::max(1L, config_.max_streams_per_connection);
+        config_dirty_ = true;
+
+        for (auto& [host, state] : hosts_) {
+            if (!state.custom) state.limits = config_.default_host_limits;
+        }
+    }
+    wake(); // a bigger window may let queued transfers start right away
+}
+
+void ScrapeEngine::set_host_limits(const std::string& host, const HostLimits& limits) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        HostState& state = hosts_[lower(host)];
+        state.custom = true;
+        state.limits = limits;
+        state.primed = false;
+    }
+    wake();
+}
+
+void ScrapeEngine::clear_host_limits(const std::string& host) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = hosts_.find(lower(host));
+        if (it == hosts_.end()) return;
+        it->second.custom = false;
+        it->second.limits = config_.default_host_limits;
+        it->second.primed = false;
+    }
+    wake();
+}
+
+void ScrapeEngine::submit(ScrapeRequest request, Completion done) {
+    Transfer* transfer = new Transfer();
+    transfer->response.url = request.url;
+    transfer->host = host_of(request.url);
+    transfer->request = std::move(request);
+    transfer->done = std::move(done);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto [it, inserted] = hosts_.try_emplace(transfer->host);
+        HostState& state = it->second;
+        if (inserted) state.limits = config_.default_host_limits;
+
+        // A host joins the rotation when its queue goes from empty to non-empty
+        if (state.queue.empty()) rotation_.push_back(transfer->host);
+        state.queue.push_back(transfer);
+    }
+    wake();
+}
+
+void ScrapeEngine::wake() {
+#ifdef __linux__
+    uint64_t one = 1;
+    ssize_t ignored = write(wake_fd_, &one, sizeof(one));
+    (void)ignored;
+#else
+    curl_multi_wakeup(multi_);
+#endif
+}
+
+// Pushes the connection settings onto the multi handle. Loop thread only.
+void ScrapeEngine::apply_config() {
+    EngineConfig config;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!config_dirty_) return;
+        config = config_;
+        config_dirty_ = false;
+    }
+
+    curl_multi_setopt(multi_, CURLMOPT_PIPELINING, config.http2 ? CURLPIPE_MULTIPLEX : CURLPIPE_NOTHING);
+    curl_multi_setopt(multi_, CURLMOPT_MAX_HOST_CONNECTIONS, config.max_host_connections);
+    curl_multi_setopt(multi_, CURLMOPT_MAX_CONCURRENT_STREAMS, config.max_streams_per_connection);
+}
+
+// Decides whether `state`'s host may start one more transfer right now.
+// If not, ready_at says when it might (or stays default when only a
+// completion can free it up). Caller holds mutex_.
+bool ScrapeEngine::take_slot(HostState& state, Clock::time_point now, Clock::time_point& ready_at) {
+    if (now < state.paused_until) {
+        ready_at = state.paused_until;
+        return false;
+    }
+
+    const HostLimits& limits = state.limits;
+    if (limits.max_in_flight > 0 && state.in_flight >= limits.max_in_flight) return false;
+
+    if (limits.rate_per_second > 0) {
+        double burst = std::max(1.0, limits.burst);
+        if (!state.primed) {
+            state.tokens = burst;
+            state.primed = true;
+        } else {
+            double elapsed = std::chrono::duration<double>(now - state.refilled).count();
+            state.tokens = std::min(burst, state.tokens + elapsed * limits.rate_per_second);
+        }
+        state.refilled = now;
+
+        if (state.tokens < 1.0) {
+            double wait = (1.0 - state.tokens) / limits.rate_per_second;
+            ready_at = now + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(wait));
+            return false;
+        }
+        state.tokens -= 1.0;
+    }
+    return true;
+}
+
+// Gives the host its slot back. A 429 or 503 also benches the host for
+// Retry-After seconds (1 s if the server didn't say). Loop thread only.
+void ScrapeEngine::release_slot(const std::string& host, const ScrapeResult& result) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    HostState& state = hosts_[host];
+    state.in_flight--;
+
+    if (result.status == 429 || result.status == 503) {
+        long seconds = 1;
+        auto retry = result.headers.find("retry-after");
+        if (retry != result.headers.end()) {
+            long parsed = std::atol(retry->second.c_str()); // HTTP-dates parse as 0 and keep the default
+            if (parsed > 0) seconds = std::min(parsed, 60L);
+        }
+        state.paused_until = Clock::now() + std::chrono::seconds(seconds);
+    }
+}
+
+// Moves queued transfers onto the multi handle until the in-flight window is
+// full. Hosts are served round-robin, one transfer per turn, so a batch that is
+// mostly one host can't starve the others, and each host's token bucket and
+// in-flight cap are honored. Loop thread only.
+void ScrapeEngine::admit_pending() {
+    apply_config();
+
+    std::vector<Transfer*> batch;
+    long timeout_ms;
+    bool http2;
+    bool prior_knowledge;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timeout_ms = config_.timeout_ms;
+        http2 = config_.http2;
+        prior_knowledge = config_.http2_prior_knowledge;
+
+        Clock::time_point now = Clock::now();
+        scheduler_armed_ = false;
+
+        // Stop after a full lap of the rotation in which nobody could go
+        size_t blocked_in_a_row = 0;
+        while (!rotation_.empty() && blocked_in_a_row < rotation_.size() &&
+               in_flight_ + (long)batch.size() < config_.max_in_flight) {
+            std::string host = std::move(rotation_.front());
+            rotation_.pop_front();
+            HostState& state = hosts_[host];
+
+            Clock::time_point ready_at{};
+            if (take_slot(state, now, ready_at)) {
+                batch.push_back(state.queue.front());
+                state.queue.pop_front();
+                state.in_flight++;
+                blocked_in_a_row = 0;
+            } else {
+                blocked_in_a_row++;
+                if (ready_at > now && (!scheduler_armed_ || ready_at < scheduler_wake_)) {
+                    scheduler_armed_ = true;
+                    scheduler_wake_ = ready_at;
+                }
+            }
+
+            if (!state.queue.empty()) rotation_.push_back(std::move(host));
+        }
+    }
+
+    for (Transfer* transfer : batch) {
+        CURL* curl = ConnectionPool::instance().acquire();
+        if (!curl) {
+            transfer->response.curl_code = CURLE_FAILED_INIT;
+            transfer->response.error = curl_easy_strerror(CURLE_FAILED_INIT);
+            release_slot(transfer->host, transfer->response);
+            transfer->done(std::move(transfer->response));
+            delete transfer;
+            continue;
+        }
+
+        transfer->easy = curl;
+        curl_easy_setopt(curl, CURLOPT_URL, transfer->request.url.c_str());
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS,
+                         transfer->request.timeout_ms > 0 ? transfer->request.timeout_ms : timeout_ms);
+        curl_easy_setopt(curl, CURLOPT_PRIVATE, transfer);
+        if (http2) {
+            // h2 via ALPN on https; PIPEWAIT makes a second request to the same
+            // origin wait for the first connection instead of dialing its own.
+            curl_easy_setopt(curl, CURLOPT_HTTP_VERSION,
+                             prior_knowledge ? CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE : CURL_HTTP_VERSION_2TLS);
+            curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+        } else {
+            curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_1_1);
+        }
+        capture_result(curl, transfer->response);
+        if (transfer->request.head_only) {
+            curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+        }
+        if (!transfer->request.follow_redirects) {
+            curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 0L);
+        }
+        if (transfer->request.decode_content) {
+            curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+        }
+        if (transfer->request.on_body || transfer->request.max_body_bytes > 0) {
+            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, &ScrapeEngine::on_body_chunk);
+            curl_easy_setopt(curl, CURLOPT_WRITEDATA, transfer);
+        }
+        for (const auto& header : transfer->request.headers) {
+            transfer->headers = curl_slist_append(transfer->headers, header.c_str());
+        }
+        if (transfer->headers) curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer->headers);
+
+        start_transfer(transfer);
+    }
+}
+
+// Write callback for requests with a body hook or cap. Returning short makes
+// curl end the transfer with CURLE_WRITE_ERROR, which drain_completions
+// turns back into success when we stopped it on purpose.
+size_t ScrapeEngine::on_body_chunk(char* data, size_t size, size_t nmemb, void* userp) {
+    Transfer* transfer = static_cast<Transfer*>(userp);
+    const ScrapeRequest& request = transfer->request;
+    size_t length = size * nmemb;
+
+    size_t usable = length;
+    if (request.max_body_bytes > 0) usable = std::min(length, request.max_body_bytes - transfer->streamed);
+    transfer->streamed += usable;
+
+    bool more = true;
+    if (request.on_body) {
+        more = request.on_body(data, usable);
+    } else {
+        reserve_body(transfer->response, request.max_body_bytes);
+        transfer->response.body.append(data, usable);
+    }
+
+    if (!more || (request.max_body_bytes > 0 && transfer->streamed >= request.max_body_bytes)) {
+        transfer->response.stopped_early = true;
+        return 0;
+    }
+    return length;
+}
+
+void ScrapeEngine::start_transfer(Transfer* transfer) {
+    in_flight_++;
+    curl_multi_add_handle(multi_, transfer->easy);
+}
+
+// Hands finished transfers back to whoever submitted them.
+void ScrapeEngine::drain_completions() {
+    int msgs_left = 0;
+    while (CURLMsg* msg = curl_multi_info_read(multi_, &msgs_left)) {
+        if (msg->msg != CURLMSG_DONE) continue;
+
+        CURL* curl = msg->easy_handle;
+        Transfer* transfer = nullptr;
+        curl_easy_getinfo(curl, CURLINFO_PRIVATE, (char**)&transfer);
+
+        CURLcode code = msg->data.result;
+        if (code == CURLE_WRITE_ERROR && transfer->response.stopped_early) code = CURLE_OK;
+        finish_result(curl, code, transfer->response);
+
+        curl_multi_remove_handle(multi_, curl);
+        ConnectionPool::instance().record(curl);
+        ConnectionPool::instance().release(curl);
+        curl_slist_free_all(transfer->headers);
+        in_flight_--;
+        release_slot(transfer->host, transfer->response);
+
+        try {
+            transfer->done(std::move(transfer->response));
+        } catch (const std::exception& e) {
+            // A misbehaving callback must not take the loop thread down with it
+            std::cerr << "--- [ScrapeEngine] Completion failed: " << e.what() << " ---" << std::endl;
+        }
+        delete transfer;
+    }
+}
+
+ScrapeStream::ScrapeStream(const std::vector<std::string>& urls, const CacheOptions& cache)
+    : state_(std::make_shared<State>()) {
+    state_->undelivered = urls.size();
+
+    std::shared_ptr<State> state = state_;
+    ResponseCache& response_cache = ResponseCache::instance();
+    for (const auto& url : urls) {
+        ScrapeRequest request;
+        request.url = url;
+        response_cache.submit(std::move(request), cache, [state](ScrapeResult&& response) {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->ready.push_back(std::move(response));
+            }
+            state->ready_cv.notify_one();
+        });
+    }
+}
+
+bool ScrapeStream::next(ScrapeResult& out) {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    if (state_->undelivered == 0) return false;
+
+    state_->ready_cv.wait(lock, [&] { return !state_->ready.empty(); });
+    out = std::move(state_->ready.front());
+    state_->ready.pop_front();
+    state_->undelivered--;
+    return true;
+}
+
+size_t ScrapeStream::remaining() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->undelivered;
+}
+
+#ifdef __linux__
+
+int ScrapeEngine::on_socket(CURL*, curl_socket_t fd, int what, void* userp, void*) {
+    ScrapeEngine* self = static_cast<ScrapeEngine*>(userp);
+
+    if (what == CURL_POLL_REMOVE) {
+        epoll_ctl(self->epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+        return 0;
+    }
+
+    epoll_event ev{};
+    ev.data.fd = fd;
+    if (what & CURL_POLL_IN) ev.events |= EPOLLIN;
+    if (what & CURL_POLL_OUT) ev.events |= EPOLLOUT;
+
+    if (epoll_ctl(self->epoll_fd_, EPOLL_CTL_MOD, fd, &ev) != 0 && errno == ENOENT) {
+        epoll_ctl(self->epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+    }
+    return 0;
+}
+
+int ScrapeEngine::on_timer(CURLM*, long timeout_ms, void* userp) {
+    ScrapeEngine* self = static_cast<ScrapeEngine*>(userp);
+    self->timer_armed_ = timeout_ms >= 0;
+    self->timer_deadline_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    return 0;
+}
+
+void ScrapeEngine::run() {
+    using clock = std::chrono::steady_clock;
+    const int kMaxEvents = 256;
+    epoll_event events[kMaxEvents];
+    int running = 0;
+
+    while (true) {
+        int wait_ms = -1;
+        if (timer_armed_) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(timer_deadline_ - clock::now());
+            wait_ms = (int)std::max<long long>(0, left.count());
+        }
+        if (scheduler_armed_) {
+            // Round up so we don't spin awake a millisecond before the token is there
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(scheduler_wake_ - clock::now()) +
+                        std::chrono::milliseconds(1);
+            int scheduler_ms = (int)std::max<long long>(0, left.count());
+            wait_ms = wait_ms < 0 ? scheduler_ms : std::min(wait_ms, scheduler_ms);
+        }
+
+        int n = epoll_wait(epoll_fd_, events, kMaxEvents, wait_ms);
+        if (n < 0 && errno != EINTR) {
+            std::cerr << "--- [ScrapeEngine] epoll_wait failed: " << errno << " ---" << std::endl;
+            continue;
+        }
+
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.fd == wake_fd_) {
+                uint64_t count;
+                ssize_t ignored = read(wake_fd_, &count, sizeof(count));
+                (void)ignored;
+                continue;
+            }
+
+            int flags = 0;
+            if (events[i].events & EPOLLIN) flags |= CURL_CSELECT_IN;
+            if (events[i].events & EPOLLOUT) flags |= CURL_CSELECT_OUT;
+            if (events[i].events & (EPOLLERR | EPOLLHUP)) flags |= CURL_CSELECT_ERR;
+            curl_multi_socket_action(multi_, events[i].data.fd, flags, &running);
+        }
+
+        // curl's own deadline (connect timeouts, retries, the 0 ms kick after add_handle)
+        if (timer_armed_ && clock::now() >= timer_deadline_) {
+            timer_armed_ = false;
+            curl_multi_socket_action(multi_, CURL_SOCKET_TIMEOUT, 0, &running);
+        }
+
+        drain_completions();
+        admit_pending();
+    }
+}
+
+#else
+
+void ScrapeEngine::run() {
+    int running = 0;
+    while (true) {
+        curl_multi_perform(multi_, &running);
+        drain_completions();
+        admit_pending();
+
+        // Sleeps until a socket is ready, curl's timeout fires, submit() calls
+        // wake(), or a throttled host gets its next token
+        int wait_ms = 1000;
+        if (scheduler_armed_) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(scheduler_wake_ - Clock::now()) +
+                        std::chrono::milliseconds(1);
+            wait_ms = (int)std::max<long long>(0, std::min<long long>(wait_ms, left.count()));
+        }
+        curl_multi_poll(multi_, nullptr, 0, wait_ms, nullptr);
+    }
+}
+
+#endif
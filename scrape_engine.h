@@ -0,0 +1,205 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <chrono>
+#include <memory>
+#include <condition_variable>
+#include <map>
+#include <unordered_map>
+#include <curl/curl.h>
+#include "body_buffer.h"
+
+// Politeness limits for one host. Zero means "no limit" for each field.
+//   rate_per_second / burst: token bucket; a host may start `burst` requests
+//                            back to back, then rate_per_second after that
+//   max_in_flight:           transfers to this host running at the same time
+struct HostLimits {
+    double rate_per_second = 0;
+    double burst = 1;
+    long max_in_flight = 16;
+};
+
+// Tunables for the shared transfer engine.
+struct EngineConfig {
+    long max_in_flight = 1000;  // transfers attached to the multi handle at once
+    long timeout_ms = 5000;     // per-transfer timeout (same as the old CURLOPT_TIMEOUT 5)
+
+    // Same-origin fan-out. With http2 on, transfers to one host wait for and
+    // multiplex over a single HTTP/2 connection (up to max_streams_per_connection
+    // streams). Hosts that only speak HTTP/1.1 get a keep-alive pool of at most
+    // max_host_connections; extra transfers queue inside curl until one frees up.
+    bool http2 = true;
+    bool http2_prior_knowledge = false; // h2 straight away on http:// too (h2c test servers)
+    long max_host_connections = 6;
+    long max_streams_per_connection = 100;
+
+    // Applied to every host without its own set_host_limits() entry
+    HostLimits default_host_limits;
+};
+
+// One request handed to the engine.
+struct ScrapeRequest {
+    std::string url;
+    bool head_only = false;     // CURLOPT_NOBODY, for existence checks
+    std::vector<std::string> headers; // extra request headers, "Name: value"
+    bool follow_redirects = true;
+    long timeout_ms = 0;         // overrides EngineConfig::timeout_ms when > 0
+    bool decode_content = false; // send Accept-Encoding and let curl inflate the body
+
+    // Streaming body hook. When set, each chunk goes here (on the loop thread)
+    // instead of into ScrapeResult::body. Returning false stops the download;
+    // so does reaching max_body_bytes (0 = no cap). Either way the transfer
+    // finishes normally with ScrapeResult::stopped_early set.
+    std::function<bool(const char* data, size_t length)> on_body;
+    size_t max_body_bytes = 0;
+};
+
+// Phase timings straight from CURLINFO_*_TIME_T, in seconds. Like curl's
+// own numbers they are cumulative from the start of the transfer, so
+// connect - dns is the TCP handshake and ttfb - tls is server think time.
+struct ScrapeTimings {
+    double dns = 0;
+    double connect = 0;
+    double tls = 0;
+    double ttfb = 0;
+    double total = 0;
+};
+
+// What comes back when a transfer finishes.
+struct ScrapeResult {
+    std::string url;            // as requested
+    std::string final_url;      // after redirects
+    long status = 0;            // HTTP status, 0 if we never got one
+    CURLcode curl_code = CURLE_OK;
+    std::string error;          // empty on success
+    std::map<std::string, std::string> headers; // selected headers, lower-cased names
+    size_t bytes = 0;
+    ScrapeTimings timings;
+    BodyBuffer body;            // pooled; see body_buffer.h
+    std::string cache_status;   // "hit", "revalidated", "miss", or empty when the cache was off
+    bool stopped_early = false; // the request's body hook or cap ended the download
+
+    bool ok() const { return curl_code == CURLE_OK; }
+};
+using ScrapeResultPtr = std::shared_ptr<ScrapeResult>;
+
+// Points curl's body and header callbacks at `result`.
+void capture_result(CURL* curl, ScrapeResult& result);
+
+// Fills in status, final URL, byte count, timings and error once a transfer is over.
+void finish_result(CURL* curl, CURLcode code, ScrapeResult& result);
+
+// --- The Scrape Engine ---
+// A single background thread owns one curl_multi handle and drives every
+// transfer through it. Network waits no longer pin a CPU thread: thousands
+// of transfers can be in flight while the loop thread sleeps in epoll
+// (Linux) or curl_multi_poll (everywhere else).
+//
+// Completion callbacks run on the loop thread, so they must be quick.
+class ScrapeEngine {
+public:
+    using Completion = std::function<void(ScrapeResult&&)>;
+
+    // The process-wide engine. Created on first use, never destroyed
+    // (tearing down a thread during interpreter shutdown is not worth it).
+    static ScrapeEngine& instance();
+
+    void submit(ScrapeRequest request, Completion done);
+
+    EngineConfig config();
+    void configure(const EngineConfig& config);
+
+    // Per-host overrides of config().default_host_limits. Host names are
+    // matched case-insensitively against the URL's host part.
+    void set_host_limits(const std::string& host, const HostLimits& limits);
+    void clear_host_limits(const std::string& host);
+
+    ScrapeEngine(const ScrapeEngine&) = delete;
+    ScrapeEngine& operator=(const ScrapeEngine&) = delete;
+
+private:
+    struct Transfer;
+    using Clock = std::chrono::steady_clock;
+
+    // Scheduler state for one host. Guarded by mutex_.
+    struct HostState {
+        std::deque<Transfer*> queue;
+        long in_flight = 0;
+        bool custom = false;            // limits came from set_host_limits()
+        HostLimits limits;
+        double tokens = 0;
+        bool primed = false;            // bucket starts full on first use
+        Clock::time_point refilled;
+        Clock::time_point paused_until; // set by 429 / 503 responses
+    };
+
+    ScrapeEngine();
+
+    bool take_slot(HostState& state, Clock::time_point now, Clock::time_point& ready_at);
+    void release_slot(const std::string& host, const ScrapeResult& result);
+
+    void run();
+    void wake();
+    void apply_config();
+    void admit_pending();
+    void start_transfer(Transfer* transfer);
+    void drain_completions();
+
+    static size_t on_body_chunk(char* data, size_t size, size_t nmemb, void* userp);
+
+#ifdef __linux__
+    static int on_socket(CURL* easy, curl_socket_t fd, int what, void* userp, void* socketp);
+    static int on_timer(CURLM* multi, long timeout_ms, void* userp);
+
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    bool timer_armed_ = false;
+    std::chrono::steady_clock::time_point timer_deadline_;
+#endif
+
+    CURLM* multi_ = nullptr;
+    std::thread loop_;
+
+    std::mutex mutex_;                  // guards the scheduler, config_ and config_dirty_
+    std::unordered_map<std::string, HostState> hosts_;
+    std::deque<std::string> rotation_;  // hosts with queued transfers, in service order
+    EngineConfig config_;
+    bool config_dirty_ = true;          // multi options are only touched from the loop thread
+
+    long in_flight_ = 0;                // loop thread only
+    bool scheduler_armed_ = false;      // loop thread only: a throttled host frees up at
+    Clock::time_point scheduler_wake_;  // scheduler_wake_ even if no socket fires
+};
+
+struct CacheOptions; // response_cache.h
+
+// --- Streaming Results ---
+// Submits a batch to the engine and hands back each response the moment it
+// finishes, instead of waiting for the slowest URL. Completions land in a
+// shared queue, so dropping the stream early is safe: stragglers just fill
+// a queue nobody reads.
+class ScrapeStream {
+public:
+    ScrapeStream(const std::vector<std::string>& urls, const CacheOptions& cache);
+
+    // Blocks until the next transfer finishes. Returns false once every
+    // submitted URL has been handed out.
+    bool next(ScrapeResult& out);
+
+    // URLs not yet handed out by next()
+    size_t remaining();
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable ready_cv;
+        std::deque<ScrapeResult> ready;
+        size_t undelivered = 0;
+    };
+    std::shared_ptr<State> state_;
+};
@@ -0,0 +1,52 @@
+#include "select_stream.h"
+#include "scrape_engine.h"
+
+SelectStream::SelectStream(const std::vector<std::string>& urls, const std::string& selector,
+                           const std::string& attribute, bool first_per_scope, size_t max_values)
+    : state_(std::make_shared<State>()) {
+    // Parse once up front, so a bad selector fails here and not on the engine thread
+    HtmlSelector prototype(selector, attribute, first_per_scope, max_values);
+    state_->undelivered = urls.size();
+
+    std::shared_ptr<State> state = state_;
+    for (const auto& url : urls) {
+        auto html = std::make_shared<HtmlSelector>(prototype);
+
+        ScrapeRequest request;
+        request.url = url;
+        request.decode_content = true;  // the tokenizer wants text, so curl inflates
+        request.on_body = [html](const char* data, size_t length) { return html->feed(data, length); };
+
+        ScrapeEngine::instance().submit(std::move(request), [state, html](ScrapeResult&& response) {
+            html->finish();
+            SelectResult result;
+            result.url = std::move(response.url);
+            result.status = response.status;
+            result.curl_code = response.curl_code;
+            result.error = std::move(response.error);
+            result.bytes = response.bytes;
+            result.values = std::move(html->values());
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->ready.push_back(std::move(result));
+            }
+            state->ready_cv.notify_one();
+        });
+    }
+}
+
+bool SelectStream::next(SelectResult& out) {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    if (state_->undelivered == 0) return false;
+
+    state_->ready_cv.wait(lock, [&] { return !state_->ready.empty(); });
+    out = std::move(state_->ready.front());
+    state_->ready.pop_front();
+    state_->undelivered--;
+    return true;
+}
+
+size_t SelectStream::remaining() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->undelivered;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <deque>
+#include <condition_variable>
+#include <cstddef>
+#include <curl/curl.h>
+#include "html_select.h"
+
+// What a selecting fetch hands back: the transfer's outcome and the
+// selected values, without the body.
+struct SelectResult {
+    std::string url;
+    long status = 0;
+    CURLcode curl_code = CURLE_OK;
+    std::string error;
+    size_t bytes = 0;
+    std::vector<std::string> values;
+
+    bool ok() const { return curl_code == CURLE_OK; }
+};
+
+// --- Selecting Fetch ---
+// ScrapeStream's shape, but each body runs through an HtmlSelector on the
+// engine thread as it downloads, in the same call as the fetch. The page
+// itself is never stored, and a page that has yielded max_values stops
+// downloading. Results come back in completion order.
+class SelectStream {
+public:
+    // Throws std::invalid_argument (before anything is fetched) for a bad selector.
+    SelectStream(const std::vector<std::string>& urls, const std::string& selector,
+                 const std::string& attribute, bool first_per_scope = false, size_t max_values = 0);
+
+    // Blocks until the next page is done. False once every URL has been handed out.
+    bool next(SelectResult& out);
+
+    size_t remaining();
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable ready_cv;
+        std::deque<SelectResult> ready;
+        size_t undelivered = 0;
+    };
+    std::shared_ptr<State> state_;
+};
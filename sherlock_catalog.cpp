@@ -0,0 +1,276 @@
+#define NOMINMAX
+#include "sherlock_catalog.h"
+#include "mapped_file.h"
+#include <fstream>
+#include <filesystem>
+#include <stdexcept>
+#include <algorithm>
+#include <unordered_map>
+#include <cctype>
+#include <cstring>
+#include <nlohmann/json.hpp>
+
+namespace fs = std::filesystem;
+
+static const std::string kPlaceholder = "{username}";
+
+// --- Compiled catalog layout (written by compile_sherlock_sites.py) ---
+// header, host refs, site records, message refs, i32 codes, string pool
+static const char kCompiledMagic[4] = {'A', 'G', 'S', '1'};
+static const uint32_t kCompiledVersion = 1;
+
+struct CompiledHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t site_count;
+    uint32_t host_count;
+    uint32_t message_count;
+    uint32_t code_count;
+    uint32_t pool_bytes;
+    uint32_t reserved;
+};
+
+struct StringRef {
+    uint32_t offset;            // into the string pool
+    uint32_t length;
+};
+
+struct CompiledSite {
+    StringRef name;
+    StringRef prefix;
+    StringRef suffix;
+    uint32_t host_id;
+    uint8_t error_type;         // ErrorType
+    uint8_t repeats;
+    uint16_t reserved;
+    uint32_t first_message;     // run in the message refs
+    uint32_t message_count;
+    uint32_t first_code;        // run in the codes
+    uint32_t code_count;
+};
+
+static_assert(sizeof(CompiledHeader) == 32 && sizeof(StringRef) == 8 && sizeof(CompiledSite) == 48,
+              "record sizes are part of the file format");
+
+const char* const SherlockCatalog::kDefaultPath = "sherlock_sites.json";
+
+std::string SiteTemplate::url(const std::string& username) const {
+    std::string out;
+    out.reserve(prefix.size() + username.size() + suffix.size());
+    out.append(prefix).append(username).append(suffix);
+
+    if (repeats) {
+        for (size_t at = out.find(kPlaceholder, prefix.size() + username.size()); at != std::string::npos;
+             at = out.find(kPlaceholder, at + username.size())) {
+            out.replace(at, kPlaceholder.size(), username);
+        }
+    }
+    return out;
+}
+
+static ErrorType parse_error_type(const std::string& text) {
+    if (text == "message") return ErrorType::Message;
+    if (text == "response_url") return ErrorType::ResponseUrl;
+    return ErrorType::StatusCode;
+}
+
+// "https://{username}.tumblr.com/" -> "{username}.tumblr.com", lower-cased
+static std::string host_part(const std::string& url_template) {
+    size_t start = url_template.find("://");
+    start = start == std::string::npos ? 0 : start + 3;
+    size_t end = url_template.find_first_of("/?#", start);
+    std::string host = url_template.substr(start, end == std::string::npos ? std::string::npos : end - start);
+    std::transform(host.begin(), host.end(), host.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+    return host;
+}
+
+SherlockCatalog& SherlockCatalog::instance() {
+    static SherlockCatalog* catalog = new SherlockCatalog();
+    return *catalog;
+}
+
+std::shared_ptr<const SiteCatalog> SherlockCatalog::parse_json(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("Cannot open Sherlock catalog: " + path);
+
+    nlohmann::json j;
+    try {
+        file >> j;
+    } catch (const nlohmann::json::exception& e) {
+        throw std::runtime_error("Cannot parse Sherlock catalog " + path + ": " + e.what());
+    }
+
+    auto catalog = std::make_shared<SiteCatalog>();
+    catalog->source = path;
+    std::unordered_map<std::string, uint32_t> host_ids;
+
+    // The deque never moves its strings, so views into them stay valid
+    auto keep = [&](std::string text) -> std::string_view {
+        catalog->strings.push_back(std::move(text));
+        return catalog->strings.back();
+    };
+    // Where each site's messages / codes start; spans are taken once the vectors stop growing
+    std::vector<std::pair<size_t, size_t>> runs;
+
+    for (auto& [name, info] : j.items()) {
+        if (!info.is_object() || !info.contains("url") || !info["url"].is_string()) continue;
+        std::string url_template = info["url"];
+        size_t at = url_template.find(kPlaceholder);
+        if (at == std::string::npos) continue;
+
+        SiteTemplate site;
+        site.name = keep(name);
+        site.prefix = keep(url_template.substr(0, at));
+        site.suffix = keep(url_template.substr(at + kPlaceholder.size()));
+        site.repeats = site.suffix.find(kPlaceholder) != std::string::npos;
+        if (info.contains("errorType") && info["errorType"].is_string()) {
+            site.error_type = parse_error_type(info["errorType"]);
+        }
+
+        // errorMsg and errorCode come as a single value or a list
+        runs.emplace_back(catalog->messages.size(), catalog->codes.size());
+        if (info.contains("errorMsg")) {
+            const auto& messages = info["errorMsg"];
+            for (const auto& message : messages.is_array() ? messages : nlohmann::json::array({messages})) {
+                if (message.is_string() && !message.get<std::string>().empty()) {
+                    catalog->messages.push_back(keep(message));
+                }
+            }
+        }
+        if (info.contains("errorCode")) {
+            const auto& codes = info["errorCode"];
+            for (const auto& code : codes.is_array() ? codes : nlohmann::json::array({codes})) {
+                if (code.is_number_integer()) catalog->codes.push_back(code);
+            }
+        }
+        // A message site with nothing to look for can only go by status
+        if (site.error_type == ErrorType::Message && catalog->messages.size() == runs.back().first) {
+            site.error_type = ErrorType::StatusCode;
+        }
+
+        std::string host = host_part(url_template);
+        auto found = host_ids.find(host);
+        if (found == host_ids.end()) {
+            found = host_ids.emplace(host, (uint32_t)catalog->hosts.size()).first;
+            catalog->hosts.push_back(keep(host));
+        }
+        site.host_id = found->second;
+
+        catalog->sites.push_back(site);
+    }
+
+    for (size_t i = 0; i < catalog->sites.size(); i++) {
+        size_t messages_end = i + 1 < runs.size() ? runs[i + 1].first : catalog->messages.size();
+        size_t codes_end = i + 1 < runs.size() ? runs[i + 1].second : catalog->codes.size();
+        SiteTemplate& site = catalog->sites[i];
+        site.error_messages = {catalog->messages.data() + runs[i].first, messages_end - runs[i].first};
+        site.error_codes = {catalog->codes.data() + runs[i].second, codes_end - runs[i].second};
+    }
+    return catalog;
+}
+
+std::shared_ptr<const SiteCatalog> SherlockCatalog::load_compiled(const std::string& path) {
+    auto file = std::make_unique<MappedFile>();
+    if (!file->open_read(path)) throw std::runtime_error("Cannot open compiled Sherlock catalog: " + path);
+    auto corrupt = [&] { return std::runtime_error("Corrupt compiled Sherlock catalog: " + path); };
+
+    const char* data = file->data();
+    uint64_t size = file->size();
+    if (size < sizeof(CompiledHeader)) throw corrupt();
+    const CompiledHeader& header = *reinterpret_cast<const CompiledHeader*>(data);
+    if (std::memcmp(header.magic, kCompiledMagic, 4) != 0) throw corrupt();
+    if (header.version != kCompiledVersion) {
+        throw std::runtime_error("Compiled Sherlock catalog " + path + " is version " +
+                                 std::to_string(header.version) + ", expected " + std::to_string(kCompiledVersion));
+    }
+
+    uint64_t hosts_at = sizeof(CompiledHeader);
+    uint64_t sites_at = hosts_at + (uint64_t)header.host_count * sizeof(StringRef);
+    uint64_t messages_at = sites_at + (uint64_t)header.site_count * sizeof(CompiledSite);
+    uint64_t codes_at = messages_at + (uint64_t)header.message_count * sizeof(StringRef);
+    uint64_t pool_at = codes_at + (uint64_t)header.code_count * sizeof(int32_t);
+    if (pool_at + header.pool_bytes != size) throw corrupt();
+
+    const StringRef* host_refs = reinterpret_cast<const StringRef*>(data + hosts_at);
+    const CompiledSite* records = reinterpret_cast<const CompiledSite*>(data + sites_at);
+    const StringRef* message_refs = reinterpret_cast<const StringRef*>(data + messages_at);
+    const int32_t* codes = reinterpret_cast<const int32_t*>(data + codes_at);
+    const char* pool = data + pool_at;
+
+    auto text = [&](const StringRef& ref) {
+        if ((uint64_t)ref.offset + ref.length > header.pool_bytes) throw corrupt();
+        return std::string_view(pool + ref.offset, ref.length);
+    };
+
+    auto catalog = std::make_shared<SiteCatalog>();
+    catalog->source = path;
+    catalog->hosts.reserve(header.host_count);
+    for (uint32_t i = 0; i < header.host_count; i++) catalog->hosts.push_back(text(host_refs[i]));
+    catalog->messages.reserve(header.message_count);
+    for (uint32_t i = 0; i < header.message_count; i++) catalog->messages.push_back(text(message_refs[i]));
+
+    catalog->sites.resize(header.site_count);
+    for (uint32_t i = 0; i < header.site_count; i++) {
+        const CompiledSite& record = records[i];
+        if (record.host_id >= header.host_count || record.error_type > (uint8_t)ErrorType::ResponseUrl ||
+            (uint64_t)record.first_message + record.message_count > header.message_count ||
+            (uint64_t)record.first_code + record.code_count > header.code_count) {
+            throw corrupt();
+        }
+
+        SiteTemplate& site = catalog->sites[i];
+        site.name = text(record.name);
+        site.prefix = text(record.prefix);
+        site.suffix = text(record.suffix);
+        site.host_id = record.host_id;
+        site.error_type = (ErrorType)record.error_type;
+        site.repeats = record.repeats != 0;
+        site.error_messages = {catalog->messages.data() + record.first_message, record.message_count};
+        site.error_codes = {codes + record.first_code, record.code_count};
+    }
+    // The views above point into the mapping; the catalog keeps it open
+    catalog->mapping = std::move(file);
+    return catalog;
+}
+
+std::shared_ptr<const SiteCatalog> SherlockCatalog::load(const std::string& path) {
+    fs::path source(path);
+    if (source.extension() == ".bin") return load_compiled(path);
+
+    // Prefer the compiled sibling unless the JSON was edited after it was built
+    fs::path compiled = fs::path(source).replace_extension(".bin");
+    std::error_code ec;
+    auto compiled_time = fs::last_write_time(compiled, ec);
+    if (!ec) {
+        auto json_time = fs::last_write_time(source, ec);
+        if (ec || compiled_time >= json_time) {
+            try {
+                return load_compiled(compiled.string());
+            } catch (const std::runtime_error&) {
+                // Damaged or from another version: the JSON still works
+            }
+        }
+    }
+    return parse_json(path);
+}
+
+std::shared_ptr<const SiteCatalog> SherlockCatalog::get() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (current_) return current_;
+    }
+    reload(kDefaultPath);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return current_;
+}
+
+size_t SherlockCatalog::reload(const std::string& path) {
+    // Parse outside the lock; sweeps keep reading the old catalog meanwhile
+    std::shared_ptr<const SiteCatalog> fresh = load(path);
+    size_t count = fresh->sites.size();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    current_ = std::move(fresh);
+    return count;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <cstddef>
+#include <cstdint>
+#include "mapped_file.h"
+
+// How a site signals "no such user" (Sherlock's errorType).
+enum class ErrorType { StatusCode, Message, ResponseUrl };
+
+// A run of items owned by the SiteCatalog (C++17 has no std::span).
+template <typename T>
+struct CatalogSpan {
+    const T* items = nullptr;
+    size_t count = 0;
+
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+};
+
+// One catalog entry with its URL template split around the first {username},
+// so building a profile URL is a reserve and three appends. Every field is a
+// view into its SiteCatalog and lives exactly as long as the catalog.
+struct SiteTemplate {
+    std::string_view name;
+    std::string_view prefix;    // template text before {username}
+    std::string_view suffix;    // template text after it
+    uint32_t host_id = 0;       // index into SiteCatalog::hosts
+    ErrorType error_type = ErrorType::StatusCode;
+    CatalogSpan<std::string_view> error_messages; // errorMsg: any of these in the body = no such user
+    CatalogSpan<int32_t> error_codes;             // errorCode: statuses that mean "no such user"
+    bool repeats = false;       // suffix holds another {username} (rare; slow path)
+
+    std::string url(const std::string& username) const;
+};
+
+// An immutable, fully built catalog. Sweeps hold a shared_ptr to the one they
+// started with, so a reload never changes the sites under a running sweep.
+// The views in `sites` and `hosts` point into `mapping` (a compiled .bin,
+// read in place) or, for a catalog parsed from JSON, into `strings`.
+struct SiteCatalog {
+    std::vector<SiteTemplate> sites;    // in name order, as nlohmann::json iterates
+    std::vector<std::string_view> hosts; // distinct host parts ({username} kept for subdomain sites)
+    std::string source;                 // file it was loaded from
+
+    // Storage behind the views
+    std::unique_ptr<MappedFile> mapping;
+    std::deque<std::string> strings;
+    std::vector<std::string_view> messages;
+    std::vector<int32_t> codes;         // JSON only; a .bin's codes are read from the mapping
+
+    SiteCatalog() = default;
+    SiteCatalog(const SiteCatalog&) = delete;
+    SiteCatalog& operator=(const SiteCatalog&) = delete;
+};
+
+// --- The Sherlock Catalog ---
+// sherlock_sites.json used to be parsed with nlohmann::json on every sweep.
+// Now it is parsed once (at module import, or on first use) into a flat
+// SiteCatalog and only re-read when reload() is called.
+//
+// compile_sherlock_sites.py turns the JSON into sherlock_sites.bin: a
+// versioned file of fixed-size records over one string pool, with the host
+// table already built. Loading maps it, checks the records and points the
+// SiteTemplates into the pool: no JSON parsing and no string copies. reload("x.json") uses x.bin when it exists and is at least
+// as new as the JSON, and falls back to the JSON otherwise.
+class SherlockCatalog {
+public:
+    static SherlockCatalog& instance();
+
+    // The current catalog, loading kDefaultPath if nothing is loaded yet.
+    // Throws std::runtime_error if that file can't be read or parsed.
+    std::shared_ptr<const SiteCatalog> get();
+
+    // Loads `path` (or its compiled .bin, as above) and swaps it in; returns
+    // the number of sites. On error the previous catalog stays in place and
+    // std::runtime_error is thrown.
+    size_t reload(const std::string& path = kDefaultPath);
+
+    static const char* const kDefaultPath;
+
+    SherlockCatalog(const SherlockCatalog&) = delete;
+    SherlockCatalog& operator=(const SherlockCatalog&) = delete;
+
+private:
+    SherlockCatalog() = default;
+
+    static std::shared_ptr<const SiteCatalog> load(const std::string& path);
+    static std::shared_ptr<const SiteCatalog> parse_json(const std::string& path);
+    static std::shared_ptr<const SiteCatalog> load_compiled(const std::string& path);
+
+    std::mutex mutex_;
+    std::shared_ptr<const SiteCatalog> current_;
+};
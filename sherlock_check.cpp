@@ -0,0 +1,341 @@
+#define NOMINMAX
+#include "sherlock_check.h"
+#include "scrape_engine.h"
+#include "site_latency.h"
+#include "presence_cache.h"
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <chrono>
+#include <vector>
+
+// Error markers sit in the title or the first screenful; past this a page is
+// treated as a real profile rather than downloaded to the end.
+static const size_t kMessageScanLimit = 512 * 1024;
+
+// Finds any of several markers in a body that arrives in chunks, keeping just
+// enough of the previous chunk to catch a marker split across the boundary.
+class MarkerScanner {
+public:
+    explicit MarkerScanner(CatalogSpan<std::string_view> markers) : markers_(markers) {
+        for (const auto& marker : markers_) longest_ = std::max(longest_, marker.size());
+    }
+
+    // Returns true once a marker has been seen.
+    bool feed(const char* data, size_t length) {
+        if (seen_) return true;
+        window_.append(data, length);
+        for (const auto& marker : markers_) {
+            if (window_.find(marker) != std::string::npos) {
+                seen_ = true;
+                return true;
+            }
+        }
+        if (window_.size() >= longest_) window_.erase(0, window_.size() - (longest_ - 1));
+        return false;
+    }
+
+    bool seen() const { return seen_; }
+
+private:
+    CatalogSpan<std::string_view> markers_;
+    size_t longest_ = 1;
+    std::string window_;
+    bool seen_ = false;
+};
+
+// One site check in progress. Holding the catalog keeps `site` valid.
+struct Probe {
+    std::shared_ptr<const SiteCatalog> catalog;
+    const SiteTemplate* site = nullptr;
+    std::string username;
+    long timeout_ms = 0;        // learned from the site's history
+    SiteCheck check;
+    std::function<void(SiteCheck&&)> done;
+};
+using ProbePtr = std::shared_ptr<Probe>;
+
+static bool is_success(long status) { return status >= 200 && status < 300; }
+
+// Answers (and timeouts) feed the site's latency history; other failures
+// such as DNS errors say nothing about how fast the site is. One sample per
+// check: the request that concluded it.
+static void observe(const ProbePtr& probe, const ScrapeResult& result) {
+    bool timed_out = result.curl_code == CURLE_OPERATION_TIMEDOUT;
+    if (result.ok() || timed_out) {
+        SiteLatency::instance().record(probe->site->name, result.timings.total, timed_out);
+    }
+}
+
+static void conclude(const ProbePtr& probe, SiteStatus status, const ScrapeResult& result) {
+    observe(probe, result);
+    probe->check.http_status = result.status;
+    probe->check.elapsed = result.timings.total;
+    if (!result.ok()) {
+        status = SiteStatus::Unknown;
+        probe->check.error = result.error;
+    }
+    probe->check.status = status;
+    PresenceCache::instance().store(probe->site->name, probe->username, probe->check);
+    probe->done(std::move(probe->check));
+}
+
+// --- Existence probe ladder ---
+// Rungs, cheapest first. A refusal moves the probe one rung down instead
+// of being read as "no such user"; the rung that finally answered is kept
+// per host so the next probe there starts on it.
+enum class ProbeMethod : uint8_t { Head, RangeGet, CappedGet };
+
+static const char* const kProbeMethodNames[] = {"HEAD", "RANGE", "GET"};
+
+static std::mutex g_probe_methods_mutex;
+static std::unordered_map<std::string, ProbeMethod> g_probe_methods;  // only hosts where HEAD failed
+
+static ProbeMethod probe_method(const std::string& host) {
+    std::lock_guard<std::mutex> lock(g_probe_methods_mutex);
+    auto it = g_probe_methods.find(host);
+    return it == g_probe_methods.end() ? ProbeMethod::Head : it->second;
+}
+
+static void remember_probe_method(const std::string& host, ProbeMethod method) {
+    std::lock_guard<std::mutex> lock(g_probe_methods_mutex);
+    g_probe_methods[host] = method;
+}
+
+std::map<std::string, std::string> probe_methods() {
+    std::lock_guard<std::mutex> lock(g_probe_methods_mutex);
+    std::map<std::string, std::string> out;
+    for (const auto& [host, method] : g_probe_methods) out[host] = kProbeMethodNames[(int)method];
+    return out;
+}
+
+static bool listed_error_code(const SiteTemplate& site, long status) {
+    return std::find(site.error_codes.begin(), site.error_codes.end(), status) != site.error_codes.end();
+}
+
+// Statuses that reject the method rather than answer about the profile:
+// HEAD not allowed / not implemented, WAFs that 403 anything but a GET, and
+// servers that won't serve the range. A site's own errorCode always counts
+// as an answer.
+static bool refused(ProbeMethod method, long status, const SiteTemplate& site) {
+    if (listed_error_code(site, status)) return false;
+    switch (status) {
+    case 403:
+    case 405:
+    case 501:
+        return true;
+    case 416:
+        return method == ProbeMethod::RangeGet;
+    default:
+        return false;
+    }
+}
+
+static void probe_existence(ProbePtr probe, ProbeMethod method, bool descended) {
+    ScrapeRequest request;
+    request.url = probe->check.url;
+    request.timeout_ms = probe->timeout_ms;
+    // response_url sites redirect missing users away; the redirect itself is the answer
+    request.follow_redirects = probe->site->error_type != ErrorType::ResponseUrl;
+    request.head_only = method == ProbeMethod::Head;
+    if (method == ProbeMethod::RangeGet) request.headers.push_back("Range: bytes=0-1");
+    if (method != ProbeMethod::Head) request.on_body = [](const char*, size_t) { return false; }; // status is all we need
+
+    ScrapeEngine::instance().submit(std::move(request), [probe, method, descended](ScrapeResult&& result) {
+        std::string host(probe->catalog->hosts[probe->site->host_id]);
+        if (result.ok() && method != ProbeMethod::CappedGet && refused(method, result.status, *probe->site)) {
+            probe_existence(probe, (ProbeMethod)((int)method + 1), true);
+            return;
+        }
+        if (result.ok() && descended) remember_probe_method(host, method);
+
+        bool found = is_success(result.status) && !listed_error_code(*probe->site, result.status);
+        conclude(probe, found ? SiteStatus::Found : SiteStatus::NotFound, result);
+    });
+}
+
+static void probe_message(ProbePtr probe) {
+    auto scanner = std::make_shared<MarkerScanner>(probe->site->error_messages);
+
+    ScrapeRequest request;
+    request.url = probe->check.url;
+    request.decode_content = true; // markers are matched against the decoded page
+    request.timeout_ms = probe->timeout_ms;
+    request.max_body_bytes = kMessageScanLimit;
+    request.on_body = [scanner](const char* data, size_t length) { return !scanner->feed(data, length); };
+
+    ScrapeEngine::instance().submit(std::move(request), [probe, scanner](ScrapeResult&& result) {
+        conclude(probe, scanner->seen() ? SiteStatus::NotFound : SiteStatus::Found, result);
+    });
+}
+
+void check_site(std::shared_ptr<const SiteCatalog> catalog, size_t index, const std::string& username,
+                std::function<void(SiteCheck&&)> done) {
+    auto probe = std::make_shared<Probe>();
+    probe->site = &catalog->sites[index];
+    probe->catalog = std::move(catalog);
+    probe->check.site = std::string(probe->site->name);
+    probe->check.url = probe->site->url(username);
+    probe->done = std::move(done);
+    if (PresenceCache::instance().lookup(probe->site->name, username, probe->check)) {
+        probe->done(std::move(probe->check));
+        return;
+    }
+    probe->username = username;
+    probe->timeout_ms = SiteLatency::instance().timeout_ms(probe->site->name,
+                                                           ScrapeEngine::instance().config().timeout_ms);
+
+    if (probe->site->error_type == ErrorType::Message) {
+        probe_message(std::move(probe));
+    } else {
+        ProbeMethod method = probe_method(std::string(probe->catalog->hosts[probe->site->host_id]));
+        probe_existence(std::move(probe), method, false);
+    }
+}
+
+std::vector<size_t> sweep_order(const SiteCatalog& catalog) {
+    std::vector<size_t> order(catalog.sites.size());
+    std::iota(order.begin(), order.end(), 0);
+    SiteLatency& latency = SiteLatency::instance();
+    std::stable_partition(order.begin(), order.end(), [&](size_t i) { return !latency.flaky(catalog.sites[i].name); });
+    return order;
+}
+
+SherlockStream::SherlockStream(const std::string& username) : state_(std::make_shared<State>()) {
+    std::shared_ptr<const SiteCatalog> catalog = SherlockCatalog::instance().get();
+    state_->undelivered = catalog->sites.size();
+
+    std::shared_ptr<State> state = state_;
+    for (size_t i : sweep_order(*catalog)) {
+        check_site(catalog, i, username, [state](SiteCheck&& check) {
+            {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->ready.push_back(std::move(check));
+            }
+            state->ready_cv.notify_one();
+        });
+    }
+}
+
+bool SherlockStream::next(SiteCheck& out) {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    if (state_->undelivered == 0) return false;
+
+    state_->ready_cv.wait(lock, [&] { return !state_->ready.empty(); });
+    out = std::move(state_->ready.front());
+    state_->ready.pop_front();
+    if (--state_->undelivered == 0) SiteLatency::instance().flush();
+    return true;
+}
+
+size_t SherlockStream::remaining() {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->undelivered;
+}
+
+std::vector<SiteCheck> sherlock_sweep(const std::string& username) {
+    SherlockStream stream(username);
+    std::vector<SiteCheck> checks;
+    SiteCheck check;
+    while (stream.next(check)) checks.push_back(std::move(check));
+
+    std::sort(checks.begin(), checks.end(), [](const SiteCheck& a, const SiteCheck& b) { return a.site < b.site; });
+    return checks;
+}
+
+SweepFeed::SweepFeed(const std::vector<std::string>& usernames)
+    : catalog_(SherlockCatalog::instance().get()), usernames_(usernames) {
+    total_ = usernames_.size() * catalog_->sites.size();
+    // One event per check and room for all of them, so push can't fail
+    state_ = std::make_shared<State>(total_ + 1);
+
+    std::shared_ptr<State> state = state_;
+    for (size_t site : sweep_order(*catalog_)) {
+        for (size_t user = 0; user < usernames_.size(); user++) {
+            check_site(catalog_, site, usernames_[user], [state, user, site](SiteCheck&& check) {
+                state->queue.push({(uint32_t)user, (uint32_t)site, (uint8_t)check.status});
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (state->waiting.load(std::memory_order_relaxed)) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    state->ready.notify_one();
+                }
+            });
+        }
+    }
+}
+
+SweepBatch SweepFeed::drain(size_t max_events, long timeout_ms) {
+    SweepBatch batch;
+    batch.total = total_;
+
+    Event event;
+    bool have = done_ < total_ && state_->queue.pop(event);
+    if (!have && done_ < total_) {
+        // `waiting` goes up before the re-check, under the mutex a producer
+        // must take to notify, so a push can't slip between check and sleep
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        state_->waiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        state_->ready.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                               [&] { return (have = state_->queue.pop(event)); });
+        state_->waiting.store(false);
+    }
+
+    size_t taken = 0;
+    for (; have; taken++) {
+        done_++;
+        SiteStatus status = (SiteStatus)event.status;
+        if (status != SiteStatus::NotFound) {
+            const std::string& username = usernames_[event.user];
+            const SiteTemplate& site = catalog_->sites[event.site];
+            auto& hits = status == SiteStatus::Found ? batch.found : batch.unknown;
+            hits.push_back({username, std::string(site.name), site.url(username)});
+        }
+        have = taken + 1 < max_events && state_->queue.pop(event);
+    }
+
+    batch.events = taken;
+    batch.done = done_;
+    batch.finished = done_ == total_;
+    if (batch.finished && taken > 0) SiteLatency::instance().flush();
+    return batch;
+}
+
+SherlockMatrix sherlock_matrix(const std::vector<std::string>& usernames) {
+    SherlockMatrix matrix;
+    matrix.usernames = usernames;
+    matrix.catalog = SherlockCatalog::instance().get();
+    const std::vector<SiteTemplate>& sites = matrix.catalog->sites;
+    matrix.cells.assign(usernames.size() * sites.size(), (uint8_t)SiteStatus::Unknown);
+    if (matrix.cells.empty()) return matrix;
+
+    // 1. Host-major order (sites sharing a host stay together), flaky sites last
+    std::vector<size_t> order(sites.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return sites[a].host_id < sites[b].host_id; });
+    SiteLatency& latency = SiteLatency::instance();
+    std::stable_partition(order.begin(), order.end(), [&](size_t i) { return !latency.flaky(sites[i].name); });
+
+    // 2. Queue every (site, username) pair; completions fill in their cell
+    std::mutex mutex;
+    std::condition_variable all_done;
+    size_t remaining = matrix.cells.size();
+
+    for (size_t site : order) {
+        for (size_t user = 0; user < usernames.size(); user++) {
+            size_t cell = user * sites.size() + site;
+            check_site(matrix.catalog, site, usernames[user], [&, cell](SiteCheck&& check) {
+                std::lock_guard<std::mutex> lock(mutex);
+                matrix.cells[cell] = (uint8_t)check.status;
+                if (--remaining == 0) all_done.notify_one();
+            });
+        }
+    }
+
+    // 3. Wait for the last cell
+    std::unique_lock<std::mutex> lock(mutex);
+    all_done.wait(lock, [&] { return remaining == 0; });
+    SiteLatency::instance().flush();
+    return matrix;
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+#include "sherlock_catalog.h"
+#include "event_queue.h"
+
+enum class SiteStatus : uint8_t { Found, NotFound, Unknown };
+
+// The verdict for one site and one username.
+struct SiteCheck {
+    std::string site;
+    std::string url;
+    SiteStatus status = SiteStatus::Unknown;
+    long http_status = 0;
+    double elapsed = 0;         // seconds for the request that decided it
+    std::string error;          // why the status is Unknown
+    bool cached = false;        // answered from the presence cache (presence_cache.h)
+};
+
+// --- Username Detection ---
+// Sherlock's errorType rules, run on the shared engine:
+//   status_code   Status only; a 2xx not listed in errorCode means the
+//                 profile exists. Probed down a ladder, cheapest first:
+//                 HEAD, then GET with "Range: bytes=0-1", then a GET cut off
+//                 at the first body byte. A rung the server refuses (403,
+//                 405, 501; 416 for the range) isn't an answer: the probe
+//                 moves down, and the rung that answered is remembered for
+//                 that host so later probes start there.
+//   message       GET; the body streams through a marker scanner and the
+//                 download stops at the first errorMsg hit or after
+//                 kMessageScanLimit bytes. No marker means the profile exists.
+//   response_url  The same ladder without following redirects; the "no
+//                 such user" case redirects away, so only a 2xx means the
+//                 profile exists.
+// `done` runs once, on the engine thread. `catalog` is held until then.
+// Each request's timeout comes from the site's latency history (site_latency.h).
+// A verdict still fresh in the presence cache is returned without a request,
+// with `done` running on the calling thread; new verdicts are stored there.
+void check_site(std::shared_ptr<const SiteCatalog> catalog, size_t index, const std::string& username,
+                std::function<void(SiteCheck&&)> done);
+
+// host -> "RANGE" / "GET" for hosts where HEAD was refused (all others use HEAD)
+std::map<std::string, std::string> probe_methods();
+
+// Catalog indices in the order a sweep should queue them: sites on a
+// timeout streak go last, so they can't hold up the useful ones.
+std::vector<size_t> sweep_order(const SiteCatalog& catalog);
+
+// --- Streaming Sweep ---
+// Checks every catalog site for one username and hands back each SiteCheck
+// as it lands, like ScrapeStream does for pages.
+class SherlockStream {
+public:
+    explicit SherlockStream(const std::string& username);
+
+    // Blocks until the next site answers. Returns false once every site
+    // has been handed out.
+    bool next(SiteCheck& out);
+
+    // Sites not yet handed out by next()
+    size_t remaining();
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable ready_cv;
+        std::deque<SiteCheck> ready;
+        size_t undelivered = 0;
+    };
+    std::shared_ptr<State> state_;
+};
+
+// Every site's verdict, in catalog order.
+std::vector<SiteCheck> sherlock_sweep(const std::string& username);
+
+// --- Sweep Events ---
+// Feeds a UI while a sweep runs. Every finished check pushes one 12-byte
+// event into a lock-free EventQueue sized for the whole sweep, so the
+// engine thread never blocks or allocates for it. The consumer drains
+// batches: everything queued goes into one SweepBatch, with misses folded
+// into the progress count and only hits (and unknowns) spelled out. The
+// first hit reaches the UI as soon as it lands, not when the sweep ends.
+struct SweepHit {
+    std::string username;
+    std::string site;
+    std::string url;
+};
+
+struct SweepBatch {
+    size_t events = 0;                  // checks finished in this batch
+    size_t done = 0;                    // checks finished so far, this batch included
+    size_t total = 0;
+    bool finished = false;              // this is the last batch
+    std::vector<SweepHit> found;
+    std::vector<SweepHit> unknown;      // checks that couldn't decide
+};
+
+class SweepFeed {
+public:
+    // Starts checking every username against every catalog site.
+    explicit SweepFeed(const std::vector<std::string>& usernames);
+
+    // Waits up to `timeout_ms` for the first event, then takes whatever is
+    // queued (at most `max_events`) as one batch. An empty batch means the
+    // wait timed out.
+    SweepBatch drain(size_t max_events = 4096, long timeout_ms = 250);
+
+    bool finished() const { return done_ == total_; }
+
+private:
+    struct Event {
+        uint32_t user;
+        uint32_t site;
+        uint8_t status;     // SiteStatus
+    };
+    struct State {
+        explicit State(size_t capacity) : queue(capacity) {}
+        EventQueue<Event> queue;
+        std::mutex mutex;               // only for sleeping in drain()
+        std::condition_variable ready;
+        std::atomic<bool> waiting{false};
+    };
+
+    std::shared_ptr<State> state_;
+    std::shared_ptr<const SiteCatalog> catalog_;
+    std::vector<std::string> usernames_;
+    size_t total_ = 0;
+    size_t done_ = 0;
+};
+
+// --- Batch Sweep ---
+// N candidate usernames against every site in one run. Jobs are queued
+// host by host, every candidate for a site back to back, so the engine's
+// per-host queue walks them over that host's keep-alive connections
+// instead of N separate sweeps each dialing every site.
+struct SherlockMatrix {
+    std::vector<std::string> usernames;
+    std::shared_ptr<const SiteCatalog> catalog;     // columns are catalog->sites
+    std::vector<uint8_t> cells;                     // row per username, SiteStatus values
+
+    size_t site_count() const { return catalog ? catalog->sites.size() : 0; }
+    SiteStatus at(size_t user, size_t site) const { return (SiteStatus)cells[user * site_count() + site]; }
+};
+
+SherlockMatrix sherlock_matrix(const std::vector<std::string>& usernames);
@@ -0,0 +1,202 @@
+#define NOMINMAX
+#include "site_latency.h"
+#include "cache_dir.h"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+static const char kMagic[4] = {'A', 'G', 'L', '1'};
+static const char* kHistoryName = "site_latency.bin";
+
+static const double kFirstBucketMs = 10.0;
+static const double kBucketGrowth = 1.25;
+
+static const uint32_t kMinSamples = 8;          // below this the default timeout applies
+static const uint32_t kDecayAt = 1024;          // halve all counts past this, so history follows change
+static const double kTimeoutFactor = 1.5;
+static const long kTimeoutMarginMs = 200;
+static const long kFloorMs = 500;
+static const uint32_t kFlakyAfter = 3;
+static const long kFlakyTimeoutMs = 1500;
+static const int kSaveIntervalSeconds = 30;
+
+SiteLatency& SiteLatency::instance() {
+    static SiteLatency* latency = new SiteLatency();
+    return *latency;
+}
+
+SiteLatency::SiteLatency() : path_(cache_path(kHistoryName)) {
+    load();
+    std::thread(&SiteLatency::save_loop, this).detach();
+}
+
+void SiteLatency::save_loop() {
+    for (;;) {
+        std::this_thread::sleep_for(std::chrono::seconds(kSaveIntervalSeconds));
+        flush();
+    }
+}
+
+double SiteLatency::bucket_upper_ms(int bucket) {
+    return kFirstBucketMs * std::pow(kBucketGrowth, bucket);
+}
+
+double SiteLatency::percentile_ms(const History& history, double p) {
+    if (history.samples == 0) return 0;
+    uint64_t total = 0;
+    for (uint32_t count : history.counts) total += count;
+    uint64_t wanted = (uint64_t)std::ceil(p * total);
+
+    uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; i++) {
+        seen += history.counts[i];
+        if (seen >= wanted) return bucket_upper_ms(i);
+    }
+    return bucket_upper_ms(kBuckets - 1);
+}
+
+long SiteLatency::timeout_ms(std::string_view site, long default_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sites_.find(std::string(site));
+    if (it == sites_.end()) return default_ms;
+
+    const History& history = it->second;
+    if (history.timeouts_in_a_row >= kFlakyAfter) {
+        // Short first, but doubled per further timeout: a site that answers
+        // in more than kFlakyTimeoutMs is back at the default within a few
+        // tries and can answer (and so recover) instead of staying flaky
+        uint32_t extra = std::min<uint32_t>(history.timeouts_in_a_row - kFlakyAfter, 8);
+        return std::min(default_ms, kFlakyTimeoutMs << extra);
+    }
+    if (history.samples < kMinSamples) return default_ms;
+
+    long learned = (long)(percentile_ms(history, 0.99) * kTimeoutFactor) + kTimeoutMarginMs;
+    // Each timeout in the current streak doubles the allowance, so a site that
+    // just got slower can still get an answer in before the default kicks in
+    learned <<= std::min<uint32_t>(history.timeouts_in_a_row, 8);
+    return std::max(kFloorMs, std::min(default_ms, learned));
+}
+
+bool SiteLatency::flaky(std::string_view site) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sites_.find(std::string(site));
+    return it != sites_.end() && it->second.timeouts_in_a_row >= kFlakyAfter;
+}
+
+void SiteLatency::record(std::string_view site, double seconds, bool timed_out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    History& history = sites_[std::string(site)];
+
+    if (timed_out) {
+        history.timeouts_in_a_row++;
+    } else {
+        history.timeouts_in_a_row = 0;
+        double ms = seconds * 1000.0;
+        int bucket = 0;
+        while (bucket < kBuckets - 1 && ms > bucket_upper_ms(bucket)) bucket++;
+        history.counts[bucket]++;
+        history.samples++;
+
+        if (history.samples >= kDecayAt) {
+            history.samples = 0;
+            for (uint32_t& count : history.counts) {
+                count /= 2;
+                history.samples += count;
+            }
+        }
+    }
+    dirty_ = true;
+}
+
+void SiteLatency::flush() {
+    std::string data;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!dirty_) return;
+        data = serialize_locked();
+        dirty_ = false;
+    }
+    if (write(data)) return;
+
+    // Try again on the next flush
+    std::lock_guard<std::mutex> lock(mutex_);
+    dirty_ = true;
+}
+
+std::map<std::string, std::map<std::string, double>> SiteLatency::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<std::string, std::map<std::string, double>> out;
+    for (const auto& [site, history] : sites_) {
+        auto& entry = out[site];
+        entry["samples"] = history.samples;
+        entry["p50_ms"] = percentile_ms(history, 0.50);
+        entry["p99_ms"] = percentile_ms(history, 0.99);
+        entry["timeouts_in_a_row"] = history.timeouts_in_a_row;
+    }
+    return out;
+}
+
+// --- File format: magic, u32 site count, then per site
+//     u32 name length, name, u32 timeouts_in_a_row, u32 counts[kBuckets]
+void SiteLatency::load() {
+    std::ifstream file(path_, std::ios::binary);
+    if (!file) return;
+
+    char magic[4];
+    uint32_t count = 0;
+    if (!file.read(magic, 4) || std::memcmp(magic, kMagic, 4) != 0) return;
+    if (!file.read((char*)&count, sizeof(count))) return;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t length = 0;
+        if (!file.read((char*)&length, sizeof(length)) || length > 4096) return;
+        std::string name(length, '\0');
+        History history;
+        if (!file.read(&name[0], length) ||
+            !file.read((char*)&history.timeouts_in_a_row, sizeof(history.timeouts_in_a_row)) ||
+            !file.read((char*)history.counts, sizeof(history.counts))) {
+            return;
+        }
+        for (uint32_t c : history.counts) history.samples += c;
+        sites_[name] = history;
+    }
+}
+
+std::string SiteLatency::serialize_locked() {
+    std::string data(kMagic, sizeof(kMagic));
+    uint32_t count = (uint32_t)sites_.size();
+    data.append((const char*)&count, sizeof(count));
+    for (const auto& [site, history] : sites_) {
+        uint32_t length = (uint32_t)site.size();
+        data.append((const char*)&length, sizeof(length));
+        data.append(site);
+        data.append((const char*)&history.timeouts_in_a_row, sizeof(history.timeouts_in_a_row));
+        data.append((const char*)history.counts, sizeof(history.counts));
+    }
+    return data;
+}
+
+bool SiteLatency::write(const std::string& data) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+
+    // Same write-then-rename as the response cache
+    std::error_code ec;
+    std::string temp = path_ + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        file.write(data.data(), (std::streamsize)data.size());
+        if (!file) return false;
+    }
+    fs::rename(temp, path_, ec);
+    if (ec) {
+        fs::remove(path_, ec);
+        fs::rename(temp, path_, ec);
+    }
+    return !ec;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <map>
+#include <unordered_map>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+// --- Per-site Latency History ---
+// A fixed 5 s timeout lets one dead site hold a sweep for 5 s while most
+// sites answer in a few hundred ms. SiteLatency keeps a small log-scale
+// histogram of answer times per site, persisted between runs in
+// site_latency.bin under the user's cache directory (cache_dir.h), and
+// derives each request's timeout from that site's p99:
+//     timeout = clamp(p99 * kTimeoutFactor + kTimeoutMarginMs, kFloorMs, default)
+// Sites with too little history get the default. A timeout isn't a latency
+// sample (we never saw the answer); it bumps a streak counter instead, and
+// a site with kFlakyAfter timeouts in a row is "flaky": sweeps queue it last
+// and give it kFlakyTimeoutMs, doubled with each further timeout up to the
+// default, until it answers again.
+//
+// record() runs on the engine's loop thread, so it only updates memory;
+// the file is written by flush() and by a background saver thread.
+class SiteLatency {
+public:
+    static SiteLatency& instance();
+
+    // Timeout for the next request to `site`, given the engine's default.
+    long timeout_ms(std::string_view site, long default_ms);
+    bool flaky(std::string_view site);
+
+    // Feed one finished request.
+    void record(std::string_view site, double seconds, bool timed_out);
+
+    // Writes the history to disk if it changed. The saver thread also does
+    // this on its own every kSaveIntervalSeconds.
+    void flush();
+
+    // site -> {samples, p50_ms, p99_ms, timeouts_in_a_row}
+    std::map<std::string, std::map<std::string, double>> stats();
+
+    SiteLatency(const SiteLatency&) = delete;
+    SiteLatency& operator=(const SiteLatency&) = delete;
+
+private:
+    static const int kBuckets = 40;     // 10 ms * 1.25^i, up to about a minute
+
+    struct History {
+        uint32_t counts[kBuckets] = {};
+        uint32_t samples = 0;
+        uint32_t timeouts_in_a_row = 0;
+    };
+
+    SiteLatency();
+
+    static double bucket_upper_ms(int bucket);
+    static double percentile_ms(const History& history, double p);
+
+    void load();
+    void save_loop();
+    std::string serialize_locked();
+    bool write(const std::string& data);
+
+    std::mutex mutex_;
+    std::unordered_map<std::string, History> sites_;
+    std::string path_;
+    bool dirty_ = false;
+    std::mutex write_mutex_;            // one writer of path_ at a time, without holding mutex_
+};
@@ -0,0 +1,53 @@
+// Checks for the harvester's entity extractor. Run through ctest, or directly:
+// exits non-zero and names the failing check.
+#include "entity_extractor.h"
+#include "test_expect.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static ExtractedEntities extract(const std::string& text, uint32_t kinds, const std::string& domain = "") {
+    return extract_entities(text.data(), text.size(), kinds, domain);
+}
+
+// The same text fed one byte at a time must give the same answer
+static ExtractedEntities extract_bytewise(const std::string& text, uint32_t kinds, const std::string& domain = "") {
+    EntityExtractor extractor(kinds, domain);
+    for (char c : text) extractor.feed(&c, 1);
+    extractor.finish();
+    return std::move(extractor.results());
+}
+
+static void test_urls() {
+    expect(extract("see https://a.example.com/x,https://b.example.com/y,http://c.example.com/", kEntityUrls).urls,
+           {"https://a.example.com/x", "https://b.example.com/y", "http://c.example.com/"},
+           "comma-joined URLs are separate entities");
+    expect(extract("links: https://a.example.com/, https://b.example.com/.", kEntityUrls).urls,
+           {"https://a.example.com/", "https://b.example.com/"},
+           "trailing punctuation is trimmed");
+    expect(extract("<a href=\"https://a.example.com/?q=1&amp;p=2&quot;>x", kEntityUrls).urls,
+           {"https://a.example.com/?q=1&p=2"},
+           "&amp; decoded, &quot; ends the URL");
+    expect(extract_bytewise("x https://a.example.com/x,https://b.example.com/y y", kEntityUrls).urls,
+           {"https://a.example.com/x", "https://b.example.com/y"},
+           "comma-joined URLs fed in one-byte chunks");
+}
+
+static void test_hosts_and_addresses() {
+    ExtractedEntities found = extract("mail staff@example.com via mx.example.com, www.example.com.evil.net and "
+                                      "10.0.0.1 or v1.2.3.4 or fe80::1 but not std::string",
+                                      kEntityAll, "Example.com");
+    expect(found.emails, {"staff@example.com"}, "emails");
+    expect(found.subdomains, {"mx.example.com"}, "subdomains stop at the target domain");
+    expect(found.ipv4, {"10.0.0.1"}, "ipv4 skips version strings");
+    expect(found.ipv6, {"fe80::1"}, "ipv6 skips C++ scopes");
+    expect(extract("bound to ::1 and ::, then called ::f", kEntityIPv6).ipv6, {"::1"},
+           "the loopback is an address, a lone ::f is not");
+}
+
+int main() {
+    test_urls();
+    test_hosts_and_addresses();
+    if (test_failures() == 0) std::printf("entity extractor: all checks passed\n");
+    return test_failures() == 0 ? 0 : 1;
+}
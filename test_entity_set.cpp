@@ -0,0 +1,61 @@
+// Checks for host / email normalization and EntitySet ranking. Run through
+// ctest, or directly: exits non-zero and names the failing check.
+#include "entity_set.h"
+#include "test_expect.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static void test_normalize_host() {
+    // RFC 3492 / IDNA vectors
+    expect({normalize_host("bücher.example")}, {"xn--bcher-kva.example"}, "latin-1 label to punycode");
+    expect({normalize_host("правительство.рф")}, {"xn--80aealotwbjpid2k.xn--p1ai"}, "cyrillic labels to punycode");
+    expect({normalize_host("ПРАВИТЕЛЬСТВО.РФ")}, {"xn--80aealotwbjpid2k.xn--p1ai"}, "cyrillic case folded first");
+
+    expect({normalize_host("WWW.Bücher.Example.")}, {"www.xn--bcher-kva.example"}, "mixed case and trailing dot");
+    expect({normalize_host("Mail.Example.COM..")}, {"mail.example.com"}, "every trailing dot goes");
+    expect({normalize_host("www.xn--bcher-kva.example")}, {"www.xn--bcher-kva.example"}, "punycode is left alone");
+    expect({normalize_host(".")}, {""}, "nothing left");
+}
+
+static void test_normalize_email() {
+    expect({normalize_email("John.Doe@Example.COM.")}, {"John.Doe@example.com"}, "local part kept, domain normalized");
+    expect({normalize_email("info@Bücher.example")}, {"info@xn--bcher-kva.example"}, "IDN domain");
+}
+
+static std::vector<std::string> summary(const EntitySet& set) {
+    std::vector<std::string> out;
+    for (const HarvestedEntity& entity : set.ranked()) {
+        out.push_back(entity.value + " " + std::to_string(entity.sources) + "/" + std::to_string(entity.mentions));
+    }
+    return out;
+}
+
+static void test_ranking() {
+    EntitySet set;
+    // Three pages, each inserting its distinct values once
+    set.add("a@example.com", 5);
+    set.add("b@example.com");
+    set.add("c@example.com", 2);
+    set.add("b@example.com");
+    set.add("c@example.com", 2);
+    set.add("d@example.com", 9);
+    set.add("b@example.com", 3);
+
+    expect((long long)set.size(), 4, "one entry per value");
+    expect(summary(set), {"b@example.com 3/5", "c@example.com 2/4", "d@example.com 1/9", "a@example.com 1/5"},
+           "by sources, then mentions");
+
+    EntitySet tied;
+    tied.add("late@example.com");
+    tied.add("early@example.com");
+    expect(summary(tied), {"late@example.com 1/1", "early@example.com 1/1"}, "ties keep first-seen order");
+}
+
+int main() {
+    test_normalize_host();
+    test_normalize_email();
+    test_ranking();
+    if (test_failures() == 0) std::printf("entity set: all checks passed\n");
+    return test_failures() == 0 ? 0 : 1;
+}
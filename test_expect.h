@@ -0,0 +1,28 @@
+#pragma once
+// The assertions the unit checks share: compare, and on a mismatch print
+// both sides and count the failure. Each test's main() returns
+// test_failures() == 0 ? 0 : 1, so ctest sees the result.
+#include <cstdio>
+#include <string>
+#include <vector>
+
+inline int& test_failures() {
+    static int failures = 0;
+    return failures;
+}
+
+inline void expect(const std::vector<std::string>& got, const std::vector<std::string>& want, const char* what) {
+    if (got == want) return;
+    test_failures()++;
+    std::printf("FAIL %s\n  got: ", what);
+    for (const std::string& value : got) std::printf("[%s] ", value.c_str());
+    std::printf("\n  want:");
+    for (const std::string& value : want) std::printf(" [%s]", value.c_str());
+    std::printf("\n");
+}
+
+inline void expect(long long got, long long want, const char* what) {
+    if (got == want) return;
+    test_failures()++;
+    std::printf("FAIL %s\n  got: %lld\n  want: %lld\n", what, got, want);
+}
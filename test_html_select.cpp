@@ -0,0 +1,55 @@
+// Checks for HtmlSelector against what BeautifulSoup's html.parser finds in
+// the same markup. Run through ctest, or directly: exits non-zero and names
+// the failing check.
+#include "html_select.h"
+#include "test_expect.h"
+#include <cstdio>
+#include <string>
+#include <vector>
+
+static std::vector<std::string> select(const std::string& html, const std::string& selector,
+                                       const std::string& attribute, bool first = false) {
+    return html_select(html.data(), html.size(), selector, attribute, first);
+}
+
+// Fed one byte at a time, so every construct is split across chunks
+static std::vector<std::string> select_bytewise(const std::string& html, const std::string& selector,
+                                                const std::string& attribute) {
+    HtmlSelector selector_state(selector, attribute);
+    for (char c : html) selector_state.feed(&c, 1);
+    selector_state.finish();
+    return selector_state.values();
+}
+
+static void test_raw_text() {
+    // soup.find_all('a') -> ['/t', '/ta', '/real']: html.parser treats only
+    // script and style as CDATA
+    std::string page = "<html><head><title>Results <a href=\"/t\">x</a></title></head><body>"
+                       "<textarea><a href=\"/ta\">y</a></textarea>"
+                       "<script>var s = \"<a href='/s'>\";</script><style><a href=\"/st\"></style>"
+                       "<div class=\"g\"><a href=\"/real\">z</a></div></body></html>";
+    expect(select(page, "a", "href"), {"/t", "/ta", "/real"}, "title and textarea content is markup");
+    expect(select_bytewise(page, "a", "href"), {"/t", "/ta", "/real"}, "same, fed in one-byte chunks");
+
+    // A stray end tag inside <title> doesn't end anything
+    expect(select("<title>a</b><a href=\"/after\">x</a></title><a href=\"/tail\">", "a", "href"),
+           {"/after", "/tail"}, "markup after a stray end tag in title");
+
+    expect(select("<SCRIPT>document.write('<a href=\"/s\">')</Script ><a href=\"/out\">", "a", "href"),
+           {"/out"}, "script content is skipped, end tag matched without case");
+}
+
+static void test_selectors() {
+    std::string results = "<div class=\"g x\"><h3><a href=\"/1\">one</a></h3><a href=\"/1b\">again</a></div>"
+                          "<div class=\"x\"><a href=\"/no\">no</a></div>"
+                          "<div class=\"g\"><a href=\"/2?a=1&amp;b=2\">two</a></div>";
+    expect(select(results, "div.g a", "href"), {"/1", "/1b", "/2?a=1&b=2"}, "descendant selector");
+    expect(select(results, "div.g a", "href", true), {"/1", "/2?a=1&b=2"}, "first match per result block");
+}
+
+int main() {
+    test_raw_text();
+    test_selectors();
+    if (test_failures() == 0) std::printf("html select: all checks passed\n");
+    return test_failures() == 0 ? 0 : 1;
+}
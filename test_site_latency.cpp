@@ -0,0 +1,66 @@
+// Checks for the per-site timeouts SiteLatency derives. Run through ctest, or
+// directly: exits non-zero and names the failing check. The history file goes
+// to a scratch ARGUS_CACHE_DIR, never the user's real one.
+#include "site_latency.h"
+#include "test_expect.h"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+
+static const long kDefaultMs = 5000;
+
+static void time_out(const std::string& site, int times) {
+    for (int i = 0; i < times; i++) SiteLatency::instance().record(site, kDefaultMs / 1000.0, true);
+}
+
+static void test_flaky_recovery() {
+    SiteLatency& latency = SiteLatency::instance();
+    const std::string site = "slow.example";
+    expect(latency.timeout_ms(site, kDefaultMs), kDefaultMs, "unknown site gets the default");
+
+    time_out(site, 3);
+    expect(latency.flaky(site), true, "three timeouts in a row make a site flaky");
+    expect(latency.timeout_ms(site, kDefaultMs), 1500, "a flaky site starts on the short allowance");
+    time_out(site, 1);
+    expect(latency.timeout_ms(site, kDefaultMs), 3000, "another timeout doubles it");
+    time_out(site, 1);
+    expect(latency.timeout_ms(site, kDefaultMs), kDefaultMs, "and it grows back to the default");
+    time_out(site, 20);
+    expect(latency.timeout_ms(site, kDefaultMs), kDefaultMs, "never past the default");
+
+    // Answering in 2 s, slower than the short allowance, ends the streak
+    latency.record(site, 2.0, false);
+    expect(latency.flaky(site), false, "an answer clears flaky");
+    expect(latency.timeout_ms(site, kDefaultMs), kDefaultMs, "too few samples for a learned timeout");
+}
+
+static void test_learned_timeout() {
+    SiteLatency& latency = SiteLatency::instance();
+    const std::string site = "fast.example";
+    for (int i = 0; i < 20; i++) latency.record(site, 0.05, false);
+    expect(latency.timeout_ms(site, kDefaultMs), 500, "a fast site is held to the floor");
+
+    time_out(site, 1);
+    long once = latency.timeout_ms(site, kDefaultMs);
+    time_out(site, 1);
+    expect(latency.timeout_ms(site, kDefaultMs) > once, true, "each timeout in a streak widens the allowance");
+}
+
+int main() {
+    std::filesystem::path scratch = std::filesystem::temp_directory_path() / "argus_test_site_latency";
+    std::filesystem::create_directories(scratch);
+#ifdef _WIN32
+    _putenv_s("ARGUS_CACHE_DIR", scratch.string().c_str());
+#else
+    setenv("ARGUS_CACHE_DIR", scratch.string().c_str(), 1);
+#endif
+
+    test_flaky_recovery();
+    test_learned_timeout();
+
+    std::error_code ec;
+    std::filesystem::remove_all(scratch, ec);
+    if (test_failures() == 0) std::printf("site latency: all checks passed\n");
+    return test_failures() == 0 ? 0 : 1;
+}
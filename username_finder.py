@@ -7,6 +7,7 @@ import requests
 from bs4 import BeautifulSoup
 import re
 import logging
+import core_utils.argus_cpp_core
 
 def find_usernames_from_name(full_name: str):
     """
@@ -22,12 +23,11 @@ def find_usernames_from_name(full_name: str):
     
     Returns:
         dict: {
-            'likely_usernames': [...],
+            'likely_usernames': [...],     # ranked, most likely first
             'social_profiles_found': {...}
         }
     """
     results = {
-        'likely_usernames': set(),
         'social_profiles_found': {}
     }
     
@@ -37,24 +37,10 @@ def find_usernames_from_name(full_name: str):
     results['social_profiles_found'].update(google_results)
     
     # === STRATEGY 2: Common Username Patterns ===
-    # Generate likely usernames from name
-    name_parts = full_name.lower().split()
-    if len(name_parts) >= 2:
-        first = name_parts[0]
-        last = name_parts[-1]
-        
-        patterns = [
-            f"{first}{last}",           # johndoe
-            f"{first}.{last}",          # john.doe
-            f"{first}_{last}",          # john_doe
-            f"{first}{last[0]}",        # johnd
-            f"{first[0]}{last}",        # jdoe
-            f"{last}{first}",           # doejohn
-            f"{first}{last}123",        # johndoe123
-            f"{first}_{last}_",         # john_doe_
-        ]
-        
-        results['likely_usernames'].update(patterns)
+    # The C++ core expands the name (separators, initials, suffixes,
+    # transliteration) into a ranked candidate list, best first
+    candidates = core_utils.argus_cpp_core.username_variants(full_name)
+    likely_usernames = [c.username for c in candidates]
     
     # === STRATEGY 3: Email Pattern Detection ===
     # If you have an email, extract username part
@@ -65,10 +51,22 @@ def find_usernames_from_name(full_name: str):
     # (Implementation if API key available)
     
     return {
-        'likely_usernames': list(results['likely_usernames']),
+        'likely_usernames': likely_usernames,
         'social_profiles_found': results['social_profiles_found']
     }
 
+def find_profiles_from_names(names, max_candidates: int = 40):
+    """
+    Generates username candidates for every name and checks all of them
+    against every Sherlock site in one native run.
+
+    Returns:
+        dict: {name: {username: [profile URLs found]}}
+    """
+    options = core_utils.argus_cpp_core.VariantOptions(max_candidates=max_candidates)
+    sweep = core_utils.argus_cpp_core.sherlock_names(list(names), options)
+    return sweep.profiles()
+
 def _google_search_profiles(name: str):
     """
     Searches Google for social profiles of a person.
@@ -0,0 +1,226 @@
+#define NOMINMAX
+#include "username_variants.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <cctype>
+#include <cstdint>
+
+static const size_t kMinLength = 3;         // shorter names are taken on every site
+static const size_t kMaxLength = 30;
+static const size_t kSuffixedForms = 4;     // suffixes go on this many of the best forms
+static const double kExpandedWeight = 0.9;  // mueller vs muller
+
+struct Affix {
+    const char* text;
+    double weight;
+};
+static const Affix kSeparators[] = {{".", 0.9}, {"_", 0.85}, {"-", 0.5}};
+static const Affix kSuffixes[] = {{"1", 0.35}, {"123", 0.3}, {"01", 0.25}, {"2", 0.2}, {"_", 0.2}};
+
+// U+00C0..U+017F folded to one lower-case letter. '-' drops the character
+// (x and the division sign), '*' marks the two-letter folds in fold().
+static const char kLatinFold[] =
+    "aaaaaa*ceeeeiiiidnooooo-ouuuuy**aaaaaa*ceeeeiiiidnooooo-ouuuuy*y"
+    "aaaaaaccccccccddddeeeeeeeeeegggggggghhhhiiiiiiiiii**jjkkklllllll"
+    "lllnnnnnnnnnoooooo**rrrrrrssssssssttttttuuuuuuuuuuuuwwyyyzzzzzzs";
+
+// А..я, Russian romanization as people actually type it
+static const char* const kCyrillic[32] = {
+    "a", "b", "v", "g", "d", "e", "zh", "z", "i", "y", "k", "l", "m", "n", "o", "p",
+    "r", "s", "t", "u", "f", "kh", "ts", "ch", "sh", "shch", "", "y", "", "e", "yu", "ya",
+};
+
+// Appends one code point's ASCII spelling to `plain`, and to `expanded` the
+// German / Scandinavian spelling where that differs (ü -> u vs ue).
+static void fold(uint32_t cp, bool transliterate, std::string& plain, std::string& expanded) {
+    if (cp < 0x80) {
+        if (std::isalnum((int)cp)) {
+            plain += (char)std::tolower((int)cp);
+            expanded += (char)std::tolower((int)cp);
+        }
+        return;
+    }
+    if (!transliterate) return;
+
+    const char* one = nullptr;
+    const char* other = nullptr;
+    switch (cp) {
+    case 0xC4: case 0xE4: one = "a"; other = "ae"; break;
+    case 0xD6: case 0xF6: one = "o"; other = "oe"; break;
+    case 0xDC: case 0xFC: one = "u"; other = "ue"; break;
+    case 0xC5: case 0xE5: one = "a"; other = "aa"; break;
+    case 0xD8: case 0xF8: one = "o"; other = "oe"; break;
+    case 0xC6: case 0xE6: one = "ae"; break;
+    case 0xDE: case 0xFE: one = "th"; break;
+    case 0xDF: one = "ss"; break;
+    case 0x132: case 0x133: one = "ij"; break;
+    case 0x152: case 0x153: one = "oe"; break;
+    case 0x401: case 0x451: one = "e"; break;
+    default:
+        if (cp >= 0xC0 && cp < 0x180) {
+            char c = kLatinFold[cp - 0xC0];
+            if (c != '-' && c != '*') {
+                plain += c;
+                expanded += c;
+            }
+            return;
+        }
+        if (cp >= 0x410 && cp < 0x450) one = kCyrillic[(cp - 0x410) % 32];
+        break;
+    }
+    if (!one) return;
+    plain += one;
+    expanded += other ? other : one;
+}
+
+// Next code point from UTF-8, or U+FFFD for a malformed byte (which fold drops)
+static uint32_t next_code_point(const std::string& text, size_t& i) {
+    unsigned char c = (unsigned char)text[i++];
+    if (c < 0x80) return c;
+    int extra = c >= 0xF0 ? 3 : c >= 0xE0 ? 2 : c >= 0xC0 ? 1 : -1;
+    if (extra < 0 || i + extra > text.size()) return 0xFFFD;
+    uint32_t cp = c & (0x3F >> extra);
+    for (int k = 0; k < extra; k++) {
+        unsigned char cont = (unsigned char)text[i];
+        if ((cont & 0xC0) != 0x80) return 0xFFFD;
+        cp = (cp << 6) | (cont & 0x3F);
+        i++;
+    }
+    return cp;
+}
+
+// The name's parts as plain ASCII, plus a second spelling when the expanded
+// fold differs ("Jürgen Müller" -> [jurgen muller], [juergen mueller]).
+static std::vector<std::vector<std::string>> spellings(const std::string& full_name, bool transliterate) {
+    std::vector<std::string> plain_parts, expanded_parts;
+    std::string plain, expanded;
+    auto end_part = [&] {
+        if (!plain.empty()) {
+            plain_parts.push_back(std::move(plain));
+            expanded_parts.push_back(std::move(expanded));
+        }
+        plain.clear();
+        expanded.clear();
+    };
+
+    for (size_t i = 0; i < full_name.size();) {
+        uint32_t cp = next_code_point(full_name, i);
+        if (cp == ' ' || cp == '\t' || cp == ',' || cp == '\n' || cp == '\r') {
+            end_part();
+        } else {
+            fold(cp, transliterate, plain, expanded);
+        }
+    }
+    end_part();
+
+    std::vector<std::vector<std::string>> out;
+    if (plain_parts.empty()) return out;
+    bool differs = plain_parts != expanded_parts;
+    out.push_back(std::move(plain_parts));
+    if (differs) out.push_back(std::move(expanded_parts));
+    return out;
+}
+
+using Scores = std::unordered_map<std::string, double>;
+
+static void offer(Scores& scores, std::string username, double score) {
+    if (username.size() < kMinLength || username.size() > kMaxLength) return;
+    auto [it, added] = scores.emplace(std::move(username), score);
+    if (!added) it->second = std::max(it->second, score);
+}
+
+static void add_forms(const std::vector<std::string>& parts, double weight, const VariantOptions& options,
+                      Scores& scores) {
+    const std::string& first = parts.front();
+    if (parts.size() == 1) {
+        offer(scores, first, weight);
+        return;
+    }
+
+    const std::string& last = parts.back();
+    std::string f(1, first[0]);
+    std::string l(1, last[0]);
+    std::string middle, middle_initials;
+    for (size_t i = 1; i + 1 < parts.size(); i++) {
+        middle += parts[i];
+        middle_initials += parts[i][0];
+    }
+
+    offer(scores, first + last, weight);
+    offer(scores, last + first, 0.6 * weight);
+    if (!middle.empty()) offer(scores, first + middle + last, 0.45 * weight);
+
+    if (options.separators) {
+        for (const Affix& sep : kSeparators) {
+            offer(scores, first + sep.text + last, sep.weight * weight);
+            offer(scores, last + sep.text + first, 0.55 * sep.weight * weight);
+        }
+    }
+
+    if (options.initials) {
+        offer(scores, f + last, 0.8 * weight);
+        offer(scores, first + l, 0.6 * weight);
+        offer(scores, last + f, 0.35 * weight);
+        if (options.separators) {
+            for (const Affix& sep : kSeparators) offer(scores, f + sep.text + last, 0.6 * sep.weight * weight);
+        }
+        if (!middle.empty()) {
+            offer(scores, first + middle_initials + last, 0.55 * weight);
+            offer(scores, f + middle_initials + last, 0.5 * weight);
+            offer(scores, f + middle_initials + l, 0.15 * weight);
+        }
+    }
+}
+
+static std::vector<UsernameCandidate> ranked(const Scores& scores) {
+    std::vector<UsernameCandidate> out;
+    out.reserve(scores.size());
+    for (const auto& [username, score] : scores) out.push_back({username, score, 0});
+    std::sort(out.begin(), out.end(), [](const UsernameCandidate& a, const UsernameCandidate& b) {
+        if (a.score != b.score) return a.score > b.score;
+        if (a.username.size() != b.username.size()) return a.username.size() < b.username.size();
+        return a.username < b.username;
+    });
+    return out;
+}
+
+std::vector<UsernameCandidate> username_variants(const std::string& full_name, const VariantOptions& options) {
+    Scores scores;
+    double weight = 1.0;
+    for (const auto& parts : spellings(full_name, options.transliterate)) {
+        add_forms(parts, weight, options, scores);
+        weight = kExpandedWeight;
+    }
+
+    if (options.numeric_suffixes) {
+        std::vector<UsernameCandidate> best = ranked(scores);
+        if (best.size() > kSuffixedForms) best.resize(kSuffixedForms);
+        for (const UsernameCandidate& form : best) {
+            for (const Affix& suffix : kSuffixes) offer(scores, form.username + suffix.text, suffix.weight * form.score);
+        }
+    }
+
+    std::vector<UsernameCandidate> out = ranked(scores);
+    if (out.size() > options.max_candidates) out.resize(options.max_candidates);
+    return out;
+}
+
+NameSweep sherlock_names(const std::vector<std::string>& names, const VariantOptions& options) {
+    NameSweep sweep;
+    sweep.names = names;
+
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> usernames;
+    for (size_t i = 0; i < names.size(); i++) {
+        for (UsernameCandidate& candidate : username_variants(names[i], options)) {
+            if (!seen.insert(candidate.username).second) continue;
+            candidate.name = i;
+            usernames.push_back(candidate.username);
+            sweep.candidates.push_back(std::move(candidate));
+        }
+    }
+
+    sweep.matrix = sherlock_matrix(usernames);
+    return sweep;
+}
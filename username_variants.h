@@ -0,0 +1,42 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "sherlock_check.h"
+
+// Which pattern families to generate, and how many candidates to keep.
+struct VariantOptions {
+    size_t max_candidates = 40;
+    bool separators = true;         // john.doe, john_doe, john-doe, doe.john
+    bool initials = true;           // jdoe, johnd, j.doe, jmdoe
+    bool numeric_suffixes = true;   // johndoe1, johndoe123 on the best few forms
+    bool transliterate = true;      // josé -> jose, müller -> muller and mueller, дмитрий -> dmitriy
+};
+
+struct UsernameCandidate {
+    std::string username;
+    double score = 0;               // rough prior, 1.0 = firstlast
+    size_t name = 0;                // index of the name it came from (sherlock_names)
+};
+
+// --- Username Variants ---
+// Expands a real name into likely usernames, best first. Each pattern has a
+// fixed prior (firstlast 1.0, first.last 0.9, jdoe 0.8, ...) scaled by the
+// spelling it was built from and any suffix; a username reached by several
+// patterns keeps its best score. Names are lower-cased and folded to ASCII;
+// punctuation inside a part is dropped (O'Brien -> obrien). Lone first or
+// last names are never suggested for multi-part names: they match someone
+// else on nearly every site.
+std::vector<UsernameCandidate> username_variants(const std::string& full_name,
+                                                 const VariantOptions& options = VariantOptions());
+
+// --- Name Sweep ---
+// Every name's candidates go into one sherlock_matrix run, without a trip
+// back through Python. A username produced by two names is checked once and
+// credited to the first.
+struct NameSweep {
+    std::vector<std::string> names;
+    std::vector<UsernameCandidate> candidates;  // row i of the matrix is candidates[i]
+    SherlockMatrix matrix;
+};
+
+NameSweep sherlock_names(const std::vector<std::string>& names, const VariantOptions& options = VariantOptions());